@@ -59,6 +59,42 @@
 //--------	Measure sampling frequency automatically -----------------
 // #define	USE_MEASURE_SAMPLING_FREQ
 
+//--------	Sliding Goertzel. Update magnitude every GOERTZEL_HOP samples.
+// #define	USE_SLIDING_GOERTZEL		// USE_BOARD_M5UNIFIED only.
+
+//--------	Window function of Goertzel. GOERTZEL_WINDOW_HANN, _BLACKMAN or _KAISER.
+// #define	USE_GOERTZEL_WINDOW		GOERTZEL_WINDOW_HANN		// USE_BOARD_M5UNIFIED only.
+
+//--------	Track the tone frequency and retune the BPF and Goertzel.
+// #define	USE_TONE_TRACKING		// USE_BOARD_M5UNIFIED only.
+
+//--------	Goertzel with N and the coefficient fixed at compile time. No window and no tracking.
+// #define	USE_GOERTZEL_FIXED_SIZE		// USE_BOARD_M5UNIFIED only.
+
+//--------	Coherent average of the complex Goertzel over the frames. No window and no tracking.
+// #define	USE_COHERENT_GOERTZEL	4		// The number of frames. USE_BOARD_M5UNIFIED only.
+
+//--------	Envelope by the NCO mixer and the CIC instead of Goertzel. No window and no tracking.
+// #define	USE_ENVELOPE_DETECTOR	8		// Decimation of the CIC. USE_BOARD_M5UNIFIED only.
+
+//--------	Cascaded BPF of IIR_DESIGN_BUTTERWORTH, _CHEBYSHEV or _BESSEL instead of the biquad. No tracking.
+// #define	USE_BPF_CASCADE		IIR_DESIGN_BUTTERWORTH		// USE_BOARD_M5UNIFIED only.
+
+//--------	Decimate the microphone input and run the detector at sampling_freq/USE_DECIMATION.
+// #define	USE_DECIMATION		4		// USE_BOARD_M5UNIFIED only.
+
+//--------	AGC decides the attack or release per AGC_BLOCK_SIZE samples and interpolates the gain.
+// #define	USE_AGC_BLOCK		// USE_BOARD_M5UNIFIED only.
+
+//--------	AGC reduces the gain before the peak arrives, with the delay of the look-ahead (ms).
+// #define	USE_AGC_LOOKAHEAD	4		// USE_BOARD_M5UNIFIED only.
+
+//--------	Threshold between the tracked noise floor and mark level with hysteresis, instead of the Smoother.
+// #define	USE_LEVEL_TRACKER		// USE_BOARD_M5UNIFIED only.
+
+//--------	Threshold by the Otsu method on the histogram of the recent magnitudes, instead of the Smoother.
+// #define	USE_OTSU_SLICER			// USE_BOARD_M5UNIFIED only.
+
 
 #if defined(USE_BOARD_M5UNIFIED)
 
@@ -147,6 +183,25 @@
 	constexpr int16_t MAGNITUDE_SMOOTHING_DOWN	= F2Q15(1.f/6);
 	constexpr float MAGNITUDE_THRESHOLD = 0.7;
 
+	#ifdef	USE_SLIDING_GOERTZEL
+		constexpr size_t GOERTZEL_HOP = 10;		// 1.25 ms
+	#endif
+
+	#ifdef	USE_TONE_TRACKING
+		constexpr float TRACKING_FREQ_MIN = 300;
+		constexpr float TRACKING_FREQ_MAX = 1200;
+	#endif
+
+	#ifdef	USE_BPF_CASCADE
+		constexpr float BPF_BANDWIDTH = 200;
+		constexpr int BPF_ORDER = 4;		// The number of sections.
+		constexpr IIR_DESIGN BPF_DESIGN = USE_BPF_CASCADE;
+	#else
+		constexpr float BPF_BANDWIDTH = 0;
+		constexpr int BPF_ORDER = 0;		// The 2nd order BPF of BPF_COEFFICIENTS.
+		constexpr IIR_DESIGN BPF_DESIGN = IIR_DESIGN_BUTTERWORTH;
+	#endif
+
 #elif defined(USE_PARAMETERS_OZ1JHM_ORIGINAL)
 	float sampling_freq = 8928.0;
 
@@ -199,6 +254,66 @@ int lcdindex = 0;
 
 
 #if	defined(USE_BOARD_M5UNIFIED)
+	#if defined(USE_GOERTZEL_WINDOW) && defined(USE_SLIDING_GOERTZEL)
+		#error	"USE_GOERTZEL_WINDOW can't be used with USE_SLIDING_GOERTZEL"
+	#endif
+	#if defined(USE_GOERTZEL_FIXED_SIZE) && (defined(USE_GOERTZEL_WINDOW) || defined(USE_TONE_TRACKING))
+		#error	"USE_GOERTZEL_FIXED_SIZE can't be used with USE_GOERTZEL_WINDOW or USE_TONE_TRACKING"
+	#endif
+	#if defined(USE_GOERTZEL_FIXED_SIZE) && defined(USE_SLIDING_GOERTZEL)
+		#error	"USE_GOERTZEL_FIXED_SIZE can't be used with USE_SLIDING_GOERTZEL"
+	#endif
+	#if defined(USE_COHERENT_GOERTZEL) && (defined(USE_GOERTZEL_WINDOW) || defined(USE_TONE_TRACKING))
+		#error	"USE_COHERENT_GOERTZEL can't be used with USE_GOERTZEL_WINDOW or USE_TONE_TRACKING"
+	#endif
+	#if defined(USE_COHERENT_GOERTZEL) && (defined(USE_SLIDING_GOERTZEL) || defined(USE_GOERTZEL_FIXED_SIZE))
+		#error	"USE_COHERENT_GOERTZEL can't be used with USE_SLIDING_GOERTZEL or USE_GOERTZEL_FIXED_SIZE"
+	#endif
+	#if defined(USE_ENVELOPE_DETECTOR) && (defined(USE_GOERTZEL_WINDOW) || defined(USE_TONE_TRACKING))
+		#error	"USE_ENVELOPE_DETECTOR can't be used with USE_GOERTZEL_WINDOW or USE_TONE_TRACKING"
+	#endif
+	#if defined(USE_ENVELOPE_DETECTOR) && (defined(USE_SLIDING_GOERTZEL) || defined(USE_GOERTZEL_FIXED_SIZE) || defined(USE_COHERENT_GOERTZEL))
+		#error	"USE_ENVELOPE_DETECTOR can't be used with USE_SLIDING_GOERTZEL, USE_GOERTZEL_FIXED_SIZE or USE_COHERENT_GOERTZEL"
+	#endif
+	#if defined(USE_BPF_CASCADE) && defined(USE_TONE_TRACKING)
+		#error	"USE_BPF_CASCADE can't be used with USE_TONE_TRACKING"
+	#endif
+	#if defined(USE_AGC_BLOCK) && defined(USE_AGC_LOOKAHEAD)
+		#error	"USE_AGC_BLOCK can't be used with USE_AGC_LOOKAHEAD"
+	#endif
+	#if defined(USE_LEVEL_TRACKER) && defined(USE_OTSU_SLICER)
+		#error	"USE_LEVEL_TRACKER can't be used with USE_OTSU_SLICER"
+	#endif
+
+	#ifdef	USE_SLIDING_GOERTZEL
+		constexpr size_t NUMOF_RECDATA = GOERTZEL_HOP;
+		/// Magnitude is smoothed every hop, so scale the coefficients to keep the time constant.
+		constexpr int16_t SMOOTHING_UP		= MAGNITUDE_SMOOTHING_UP*GOERTZEL_HOP/NUMOF_TESTDATA;
+		constexpr int16_t SMOOTHING_DOWN	= MAGNITUDE_SMOOTHING_DOWN*GOERTZEL_HOP/NUMOF_TESTDATA;
+	#else
+		constexpr size_t NUMOF_RECDATA = NUMOF_TESTDATA;
+		constexpr int16_t SMOOTHING_UP		= MAGNITUDE_SMOOTHING_UP;
+		constexpr int16_t SMOOTHING_DOWN	= MAGNITUDE_SMOOTHING_DOWN;
+	#endif
+
+	#ifdef	USE_DECIMATION
+		constexpr int DECIMATION = USE_DECIMATION;
+	#else
+		constexpr int DECIMATION = 1;
+	#endif
+	/// NUMOF_TESTDATA, GOERTZEL_HOP and NUMOF_RECDATA are the samples at sampling_freq.
+	/// The detector runs at detector_freq over the same time spans.
+	constexpr float detector_freq = sampling_freq/DECIMATION;
+	constexpr size_t NUMOF_DETDATA = NUMOF_RECDATA/DECIMATION;
+	constexpr size_t NUMOF_DETTEST = NUMOF_TESTDATA/DECIMATION;
+	static_assert((0 == NUMOF_RECDATA%DECIMATION) && (0 == NUMOF_TESTDATA%DECIMATION),
+					"NUMOF_TESTDATA and GOERTZEL_HOP must be multiples of USE_DECIMATION");
+	#ifdef	USE_TONE_TRACKING
+		static_assert(TRACKING_FREQ_MAX < detector_freq/2, "TRACKING_FREQ_MAX must be below detector_freq/2");
+	#endif
+	/// BPF coefficients designed at compile time. No bilinear() at startup.
+	constexpr IIR2Coefficients BPF_COEFFICIENTS = IIRFilter2::coefficients(TARGET_FREQ, detector_freq, FILTER_TYPE_BPF, 0.7071);
+
 	int16_t magnitude ;
 	int16_t magnitudelimit = 100;
 	int16_t magnitudelimit_low = MAGNITUDELIMIT_LOW;
@@ -324,7 +439,30 @@ void setup() {
 
 
 #if defined(USE_BOARD_M5UNIFIED)
-	m5un_setup(target_freq, sampling_freq, NUMOF_TESTDATA, MAGNITUDE_SMOOTHING_UP, MAGNITUDE_SMOOTHING_DOWN);
+	#ifdef	USE_SLIDING_GOERTZEL
+		m5un_setup(target_freq, sampling_freq, NUMOF_TESTDATA, SMOOTHING_UP, SMOOTHING_DOWN, GOERTZEL_HOP, DECIMATION, &BPF_COEFFICIENTS, BPF_ORDER, BPF_BANDWIDTH, BPF_DESIGN);
+	#else
+		m5un_setup(target_freq, sampling_freq, NUMOF_TESTDATA, SMOOTHING_UP, SMOOTHING_DOWN, 0, DECIMATION, &BPF_COEFFICIENTS, BPF_ORDER, BPF_BANDWIDTH, BPF_DESIGN);
+		goertzel->setCallback([](int16_t mag, void* user) { *static_cast<int16_t*>(user) = mag; }, &magnitude);
+	#endif
+	#ifdef	USE_GOERTZEL_WINDOW
+		goertzel->setWindow(USE_GOERTZEL_WINDOW);
+	#endif
+	#ifdef	USE_AGC_LOOKAHEAD
+		// The detector and the decoder see the whole signal delayed by agc->getDelay() samples,
+		// so the element durations are not changed.
+		agc->setLookahead(USE_AGC_LOOKAHEAD, detector_freq);
+	#endif
+	#ifdef	USE_LEVEL_TRACKER
+		level_tracker = new LevelTracker(MAGNITUDE_THRESHOLD*MAGNITUDELIMIT_LOW, sampling_freq/NUMOF_RECDATA);
+	#endif
+	#ifdef	USE_OTSU_SLICER
+		slicer = new OtsuSlicer(MAGNITUDE_THRESHOLD*MAGNITUDELIMIT_LOW, sampling_freq/NUMOF_RECDATA);
+	#endif
+	#ifdef	USE_TONE_TRACKING
+		tone_tracker = new ToneTracker(target_freq, detector_freq, NUMOF_DETTEST, TRACKING_FREQ_MIN, TRACKING_FREQ_MAX);
+		tone_tracker->attach(bpf, goertzel, sliding_goertzel);
+	#endif
 #else
 	Serial.begin(115200); 
 	pinMode(ledPin, OUTPUT);
@@ -380,22 +518,61 @@ void loop() {
 	// The basic where we get the tone //
 	/////////////////////////////////////
 #if defined(USE_BOARD_M5UNIFIED)
-	static int16_t recBuf[NUMOF_TESTDATA];
-	M5.Mic.record(recBuf, sizeof(recBuf)/sizeof(recBuf[0]), sampling_freq);
-	memcpy(testData, recBuf, sizeof(testData));
-
-	bpf->filter(testData, testData, n);
-	agc->process(testData, testData, n);
+	/// M5.Mic.record() has 2 requests in flight and returns when the one
+	/// queued 2 calls before is done, so that buffer can be processed in place.
+	static int16_t recBuf[3][NUMOF_RECDATA];
+	static int recIndex = 0;
+	M5.Mic.record(recBuf[recIndex], NUMOF_RECDATA, sampling_freq);
+	recIndex = (recIndex + 1) % 3;
+	int16_t* recData = recBuf[recIndex];
+
+	#ifdef	USE_DECIMATION
+		decimator->decimate(recData, recData, NUMOF_RECDATA);	// NUMOF_DETDATA outputs.
+	#endif
+	#ifdef	USE_TONE_TRACKING
+		tone_tracker->push(recData, NUMOF_DETDATA, HIGH == realstate);	// Before the BPF overwrites recData.
+	#endif
+	#ifdef	USE_BPF_CASCADE
+		bpf_cascade->filter(recData, recData, NUMOF_DETDATA);
+	#else
+		bpf->filter(recData, recData, NUMOF_DETDATA);
+	#endif
+	#ifdef	USE_AGC_BLOCK
+		agc->processBlock(recData, recData, NUMOF_DETDATA);
+	#elif defined(USE_AGC_LOOKAHEAD)
+		agc->processLookahead(recData, recData, NUMOF_DETDATA);
+	#else
+		agc->process(recData, recData, NUMOF_DETDATA);
+	#endif
 
-	magnitude = goertzel->getMagnitude(testData);
+	#ifdef	USE_SLIDING_GOERTZEL
+		magnitude = sliding_goertzel->getMagnitude(recData);
+	#elif defined(USE_GOERTZEL_FIXED_SIZE)
+		static GoertzelN<NUMOF_DETTEST> goertzel_fixed(TARGET_FREQ, detector_freq, false);
+		magnitude = goertzel_fixed.getMagnitude(recData);
+	#elif defined(USE_COHERENT_GOERTZEL)
+		static CoherentGoertzel goertzel_coherent(TARGET_FREQ, detector_freq, NUMOF_DETTEST, USE_COHERENT_GOERTZEL, false);
+		magnitude = goertzel_coherent.getMagnitude(recData);
+	#elif defined(USE_ENVELOPE_DETECTOR)
+		static EnvelopeDetector envelope(TARGET_FREQ, detector_freq, NUMOF_DETTEST, USE_ENVELOPE_DETECTOR);
+		magnitude = envelope.getMagnitude(recData);
+	#else
+		goertzel->push(recData, NUMOF_DETDATA);		// Callback updates magnitude every NUMOF_DETTEST samples.
+	#endif
 	
 	/////////////////////////////////////////////////////////// 
 	// here we will try to set the magnitude limit automatic //
 	///////////////////////////////////////////////////////////
 
-	smoother->smooth(&magnitudelimit, &magnitude, 1);
+	#if defined(USE_LEVEL_TRACKER)
+		level_tracker->push(magnitude);
+	#elif defined(USE_OTSU_SLICER)
+		slicer->push(magnitude);
+	#else
+		smoother->smooth(&magnitudelimit, &magnitude, 1);
 
-	magnitudelimit = max(magnitudelimit, magnitudelimit_low);
+		magnitudelimit = max(magnitudelimit, magnitudelimit_low);
+	#endif
 #else
 	for (char index = 0; index < n; index++){
 		testData[index] = analogRead(audioInPin);
@@ -430,10 +607,16 @@ void loop() {
 	// now we check for the magnitude //
 	////////////////////////////////////
 
+#if defined(USE_BOARD_M5UNIFIED) && defined(USE_LEVEL_TRACKER)
+	realstate = (level_tracker->isMark())? HIGH : LOW;
+#elif defined(USE_BOARD_M5UNIFIED) && defined(USE_OTSU_SLICER)
+	realstate = (slicer->isMark())? HIGH : LOW;
+#else
 	if(magnitude > magnitudelimit*MAGNITUDE_THRESHOLD)	// just to have some space up 
 		 realstate = HIGH; 
 	else
 		realstate = LOW; 
+#endif
 	
 	///////////////////////////////////////////////////// 
 	// here we clean up the state with a noise blanker //
@@ -695,7 +878,13 @@ void updateinfolinelcd(){
 	/////////////////////////////////////
 
 #if defined(USE_BOARD_M5UNIFIED)
-	m5un_loop(wpm, filteredstate, magnitude, MAGNITUDE_THRESHOLD*magnitudelimit);
+	#if defined(USE_LEVEL_TRACKER)
+		m5un_loop(wpm, filteredstate, magnitude, level_tracker->getThreshold());
+	#elif defined(USE_OTSU_SLICER)
+		m5un_loop(wpm, filteredstate, magnitude, slicer->getThreshold());
+	#else
+		m5un_loop(wpm, filteredstate, magnitude, MAGNITUDE_THRESHOLD*magnitudelimit);
+	#endif
 #else
 	int place;
 	if (rows == 4){
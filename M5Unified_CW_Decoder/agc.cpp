@@ -42,24 +42,145 @@
 
 void Agc::process(int16_t* out, const int16_t* in, size_t nSamples)
 {
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_AGC);
+
 	for( ; 0 < nSamples; nSamples--) {
 		*out = round_fx(L_shl(L_mult(*in, extract_h(gain)), 15 - AGC_GAIN_Qn));
-		if(target < abs_s(*out)) {
-			// gain(n) = attack*gain(n-1)
-			gain = L_mult(round_fx(gain), attack);		
-		} else {
-			// gain(n) = ((1 - gain(n-1))/4)*release + gain(n-1)
-			//				 = release/4 - (1 - release/4)*gain(n-1)
-			int16_t acc = sub(INT16_MAX, round_fx(gain));
-			acc = shr(acc, 2);
-			gain = L_mac(gain, acc, release);
-		}
-		gain = L_max(L_deposit_h(minGain), L_min(L_deposit_h(maxGain), gain));
+		update(abs_s(*out));
 
 		in++;
 		out++;
 	}
 }
+
+/**
+* @brief	Attack or release of the gain by the output level.
+*/
+inline void Agc::update(int16_t level)
+{
+	if(target < level) {
+		// gain(n) = attack*gain(n-1)
+		gain = L_mult(round_fx(gain), attack);		
+	} else {
+		// gain(n) = ((1 - gain(n-1))/4)*release + gain(n-1)
+		//				 = release/4 - (1 - release/4)*gain(n-1)
+		int16_t acc = sub(INT16_MAX, round_fx(gain));
+		acc = shr(acc, 2);
+		gain = L_mac(gain, acc, release);
+	}
+	gain = L_max(L_deposit_h(minGain), L_min(L_deposit_h(maxGain), gain));
+}
+
+/**
+* @brief	AGC with the look-ahead of setLookahead(). The output is delayed by
+*			getDelay() samples.
+*
+* @remark	The gain of process() is tracked with the delayed samples. The
+*			look-ahead limits it to target/peak, where the peak is the sliding
+*			max of the delay + 1 input samples, i.e. of the samples in the delay
+*			line. The limited gain is averaged over the delay + 1 samples, so it
+*			ramps down linearly and reaches target/peak when the peak is output.
+*			So the output doesn't overshoot unless the gain is limited by
+*			setMinGain().
+*/
+void Agc::processLookahead(int16_t* out, const int16_t* in, size_t nSamples)
+{
+	if(0 == lookahead) {
+		process(out, in, nSamples);
+		return;
+	}
+
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_AGC);
+
+	for( ; 0 < nSamples; nSamples--) {
+		int16_t x = *in++;
+		int16_t peak = peak_detector.push(abs_s(x));
+		int16_t g = extract_h(gain);
+
+		// Limit of the gain by the peak in the delay line.
+		int16_t limit = g;
+		if(target < round_fx(L_shl(L_mult(peak, g), 15 - AGC_GAIN_Qn))) {
+			limit = s_min(g, div_l(L_shl(L_deposit_l(target), AGC_GAIN_Qn + 1), peak));	// target/peak
+		}
+		limit_sum = L_add(L_sub(limit_sum, limit_line[limit_pos]), limit);
+		limit_line[limit_pos] = limit;
+		limit_pos = (lookahead == limit_pos)? 0 : limit_pos + 1;
+
+		int16_t y = delay_line[pos];
+		delay_line[pos] = x;
+		pos = (lookahead - 1 == pos)? 0 : pos + 1;
+
+		*out++ = round_fx(L_shl(L_mult(y, extract_l(L_mls(limit_sum, average))), 15 - AGC_GAIN_Qn));
+		update(abs_s(round_fx(L_shl(L_mult(y, g), 15 - AGC_GAIN_Qn))));
+	}
+}
+
+/**
+* @brief	Set the look-ahead of processLookahead().
+*
+* @param[in] ms		Look-ahead (ms). 0 is the same as process().
+* @param[in] fs		Sampling frequency (Hz).
+*/
+void Agc::setLookahead(float ms, float fs)
+{
+	lookahead = std::min(std::max(0.f, ms*fs/1000 + 0.5f), AGC_LOOKAHEAD_MAX - 1.f);
+	peak_detector.setWindow(lookahead + 1);
+	std::fill(delay_line, delay_line + AGC_LOOKAHEAD_MAX, 0);
+	pos = 0;
+
+	int16_t g = extract_h(L_max(L_deposit_h(minGain), gain));
+	std::fill(limit_line, limit_line + AGC_LOOKAHEAD_MAX, g);
+	limit_sum = (lookahead + 1)*g;
+	limit_pos = 0;
+	average = 32768/(lookahead + 1);
+	AGC_DEBUG_PRINT("Agc::lookahead = %d\n", lookahead);
+}
+
+/**
+* @brief	AGC with a decision per sub-block of AGC_BLOCK_SIZE samples.
+*
+* @remark	The peak of the sub-block times the gain decides the attack or release,
+*			and the gain at the end of the sub-block is attack^AGC_BLOCK_SIZE or
+*			release^AGC_BLOCK_SIZE of the gain at the start, the same time constants
+*			as process(). The gain is linearly interpolated across the sub-block, so
+*			the inner loop has no data dependent branch.
+*/
+void Agc::processBlock(int16_t* out, const int16_t* in, size_t nSamples)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_AGC);
+
+	while(0 < nSamples) {
+		int num = (nSamples < AGC_BLOCK_SIZE)? nSamples : AGC_BLOCK_SIZE;
+
+		int16_t peak = 0;
+		for(int i = 0; i < num; i++) {
+			peak = s_max(peak, abs_s(in[i]));
+		}
+
+		int32_t end;
+		if(target < round_fx(L_shl(L_mult(peak, extract_h(gain)), 15 - AGC_GAIN_Qn))) {
+			// gain(n+L) = attack^L*gain(n)
+			end = L_mult(round_fx(gain), attack_blk);
+		} else {
+			// gain(n+L) = (1 - gain(n))*(1 - (1 - release)^L) + gain(n)
+			end = L_mac(gain, sub(INT16_MAX, round_fx(gain)), release_blk);
+		}
+		end = L_max(L_deposit_h(minGain), L_min(L_deposit_h(maxGain), end));
+
+		int32_t step = L_shr(L_sub(end, gain), AGC_BLOCK_LOG2);
+		for(int i = 0; i < num; i++) {
+			gain = L_add(gain, step);
+			out[i] = round_fx(L_shl(L_mult(in[i], extract_h(gain)), 15 - AGC_GAIN_Qn));
+		}
+		if(AGC_BLOCK_SIZE == num) {
+			gain = end;
+		}
+
+		in += num;
+		out += num;
+		nSamples -= num;
+	}
+}
 		
 float Agc::ms2CoefA1(float ms, float fs)
 {
@@ -70,12 +191,14 @@ float Agc::ms2CoefA1(float ms, float fs)
 void Agc::setAttackTime(float ms, float fs)
 {
 	attack = 32768.*ms2CoefA1(ms, fs) + 0.5;
+	attack_blk = std::min(32767., 32768.*ms2CoefA1(ms, fs/AGC_BLOCK_SIZE) + 0.5);
 	AGC_DEBUG_PRINT("Agc::attack = 0x%04X\n", attack);
 }
 
 void Agc::setReleaseTime(float ms, float fs)
 {
 	release = (1<<2)*32768.*(1.f - ms2CoefA1(ms, fs)) + 0.5;
+	release_blk = std::min(32767., 32768.*(1.f - ms2CoefA1(ms, fs/AGC_BLOCK_SIZE)) + 0.5);
 	AGC_DEBUG_PRINT("Agc::release = 0x%04X\n", release);
 }
 
@@ -97,6 +220,149 @@ void Agc::setMinGain(float amp)
 	minGain = (1<<AGC_GAIN_Qn)*amp + 0.5;
 	AGC_DEBUG_PRINT("Agc::minGain = 0x%04X\n", minGain);
 }
+
+
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "f2q.h"
+
+/**
+* @brief	Check of SlidingMax and SlidingMin of the peak detector against the brute force,
+*			with the monotonic inputs and the window up to the capacity.
+*
+* @return	The number of the mismatches.
+*/
+static int checkSliding(void)
+{
+	const int N = AGC_LOOKAHEAD_MAX;
+	const int num = 1000;
+	static const char* const name[] = { "decreasing", "increasing", "random" };
+	int16_t x[num];
+	int errors = 0;
+
+	for(int v = 0; v < 3; v++) {
+		for(int n = 0; n < num; n++) {
+			x[n] = (0 == v)? 30000 - 30*n : (1 == v)? -30000 + 30*n : rand() - RAND_MAX/2;
+		}
+		for(int window = 1; window <= N; window++) {
+			SlidingMax<int16_t, N> smax(window);
+			SlidingMin<int16_t, N> smin(window);
+			int mismatches = 0;
+
+			for(int n = 0; n < num; n++) {
+				int16_t hi = x[n], lo = x[n];
+				for(int k = std::max(0, n - window + 1); k < n; k++) {
+					hi = std::max(hi, x[k]);
+					lo = std::min(lo, x[k]);
+				}
+				mismatches += (smax.push(x[n]) != hi) + (smin.push(x[n]) != lo);
+			}
+			if(mismatches) {
+				printf("Sliding %s window %d: %d mismatches\n", name[v], window, mismatches);
+			}
+			errors += mismatches;
+		}
+	}
+	printf("Sliding: %d mismatches\n\n", errors);
+
+	return errors;
+}
+
+/**
+* @brief	Benchmark of process() and processBlock() with a keyed tone of the level steps.
+*/
+int main()
+{
+	checkSliding();
+
+	const float fs = 8000;
+	const float tone = 600;
+	const int num = 10*fs;
+	const int frame = 256;
+
+	// 600 Hz keyed by 50 ms, with the level of -30, -6 and -18 dBFS for each 1/3.
+	int16_t* x = new int16_t[num];
+	for(int n = 0; n < num; n++) {
+		float level = (n < num/3)? 0.0316 : (n < 2*num/3)? 0.5 : 0.125;
+		bool on = (0 == (n/400)%2);
+		x[n] = (on)? F2Q15(level*sin(2*M_PI*tone*n/fs)) : 0;
+	}
+	static const char* const name[] = { "process", "processBlock", "processLookahead" };
+	const int paths = sizeof(name)/sizeof(name[0]);
+	int16_t* y[paths];
+
+	auto run = [](Agc& agc, int d, int16_t* out, const int16_t* in, int m) {
+		switch(d) {
+		case 0:		agc.process(out, in, m);			break;
+		case 1:		agc.processBlock(out, in, m);		break;
+		default:	agc.processLookahead(out, in, m);	break;
+		}
+	};
+
+	printf("%-16s %10s %10s %12s %12s %12s\n", "", "ns/sample", "us/second", "step(dBFS)", "peak(dBFS)", "mark(dBFS)");
+	for(int d = 0; d < paths; d++) {
+		Agc agc(0.7, 20.0, 3, 5000, fs);
+		agc.setLookahead(4, fs);
+		y[d] = new int16_t[num];
+
+		clock_t t = clock();
+		for(int rep = 0; rep < 50; rep++) {
+			for(int n = 0; n < num; n += frame) {
+				run(agc, d, y[d] + n, x + n, (num - n < frame)? num - n : frame);
+			}
+		}
+		float sec = (float)(clock() - t)/CLOCKS_PER_SEC/50;
+
+		// Overshoot at the step from -30 to -6 dBFS.
+		int delay = (2 == d)? agc.getDelay() : 0;
+		int step = 0;
+		for(int n = num/3 + delay; n < num/3 + delay + 400; n++) {
+			step = std::max(step, abs(y[d][n]));
+		}
+
+		// Output of the last key, after the gain is settled.
+		int peak = 0;
+		double power = 0;
+		int marks = 0;
+		for(int n = num - 1600; n < num; n++) {
+			peak = std::max(peak, abs(y[d][n]));
+			if(0 == (n/400)%2) {
+				power += (double)y[d][n]*y[d][n];
+				marks++;
+			}
+		}
+		printf("%-16s %10.2f %10.1f %12.2f %12.2f %12.2f\n", name[d],
+				1e9f*sec/num, 1e6f*sec/(num/fs), 20*log10(step/32768.),
+				20*log10(peak/32768.), 10*log10(2*power/marks/32768./32768.));
+	}
+
+#ifdef	WMOPS
+	for(int d = 0; d < paths; d++) {
+		Agc agc(0.7, 20.0, 3, 5000, fs);
+		agc.setLookahead(4, fs);
+
+		wmops_reset();
+		for(int n = 0; n + frame <= num; n += frame) {
+			run(agc, d, y[d] + n, x + n, frame);
+			wmops_frame();
+		}
+		printf("\n%s\n", name[d]);
+		wmops_output(fs/frame);
+	}
+#endif
+
+	delete[] x;
+	for(int d = 0; d < paths; d++) {
+		delete[] y[d];
+	}
+
+	return 0;
+}
+
+#endif
 /**
 * End
 */
@@ -31,6 +31,15 @@
 #ifndef	_AGC_HPP
 #define	_AGC_HPP
 
+//******** Configurations ********************************************
+//--------	Samples of the sub-block of Agc::processBlock() = 2^AGC_BLOCK_LOG2.
+#define	AGC_BLOCK_LOG2		4
+//--------	Max. samples of the delay line of Agc::processLookahead(). Power of 2.
+#define	AGC_LOOKAHEAD_MAX	64
+//--------------------------------------------------------------------
+#define	AGC_BLOCK_SIZE		(1 << AGC_BLOCK_LOG2)
+
+#include "sliding.hpp"
 
 class Agc {
 	public:
@@ -41,7 +50,7 @@ class Agc {
 				float maxGain =			10.0,
 				float attackTime =	5,
 				float releaseTime =	200,
-				float sample_rate =	8000) : gain(0)
+				float sample_rate =	8000) : gain(0), lookahead(0), pos(0), limit_pos(0), limit_sum(0)
 		{ 
 			setTargetLevel(target);
 			setMaxGain(maxGain);
@@ -52,20 +61,41 @@ class Agc {
 		}	
 
 		void process(int16_t* out, const int16_t* in, size_t nSamples);
+		void processBlock(int16_t* out, const int16_t* in, size_t nSamples);
+		void processLookahead(int16_t* out, const int16_t* in, size_t nSamples);
 
 		void setTargetLevel(float amp);
 		void setMaxGain(float amp);
 		void setMinGain(float amp);
 		void setAttackTime(float ms, float fs);
 		void setReleaseTime(float ms, float fs);
+		void setLookahead(float ms, float fs);
+
+		/**
+		* @brief	Delay of processLookahead() (samples).
+		*/
+		int getDelay(void) const	{ return lookahead; }
 
 	private:
-		int16_t	attack;
-		int16_t release;
+		int16_t	attack;			// Q15. = a of the attack time
+		int16_t release;		// Q13. = 1 - a of the release time
+		int16_t	attack_blk;		// Q15. = a^AGC_BLOCK_SIZE of the attack time
+		int16_t	release_blk;	// Q15. = 1 - a^AGC_BLOCK_SIZE of the release time
 
 		int32_t gain;
 		int16_t minGain;
 
+		int lookahead;						// Samples of the delay line.
+		int pos;
+		int16_t delay_line[AGC_LOOKAHEAD_MAX];
+		SlidingMax<int16_t, AGC_LOOKAHEAD_MAX> peak_detector;
+
+		int limit_pos;
+		int16_t limit_line[AGC_LOOKAHEAD_MAX];	// Limited gain of the last lookahead + 1 samples. Q10
+		int32_t limit_sum;
+		int16_t average;						// 1/(lookahead + 1). Q15
+
+		void update(int16_t level);
 		float ms2CoefA1(float ms, float fs);
 };
 
@@ -33,9 +33,10 @@
 #include "basic_op.h"
 
 
-bool Overflow = false;
-int Carry = 0;
+BASIC_OP_TLS bool Overflow = false;
+BASIC_OP_TLS int Carry = 0;
 
+#ifndef	BASIC_OP_INLINE
 /**
 * @brief	Limit the 32 bit input to the range of a 16 bit word. 
 *
@@ -49,12 +50,13 @@ int Carry = 0;
 int16_t saturate(int32_t L_v1)
 {
 	if(INT16_MAX < L_v1) {
-		Overflow = true;
+		BASIC_OP_OVERFLOW();
 		return INT16_MAX;
 	} else if(L_v1 < INT16_MIN) {
-		Overflow = true;
+		BASIC_OP_OVERFLOW();
 		return INT16_MIN;
 	} else {
+		WMOPS_UNCOUNT(extract_l);
 		return extract_l(L_v1);
 	}
 }
@@ -76,6 +78,7 @@ int16_t saturate(int32_t L_v1)
 */
 int16_t add(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(add);
 	return saturate((int32_t)v1 + v2);
 }
 
@@ -96,6 +99,7 @@ int16_t add(int16_t v1, int16_t v2)
 */
 int16_t sub(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(sub);
 	return saturate((int32_t)v1 - v2);
 }
 
@@ -117,18 +121,21 @@ int16_t sub(int16_t v1, int16_t v2)
 */
 int16_t shl(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(shl);
 	if(v2 < 0) {
 		if(v2 < -16) v2 = -16;
 		v2 = -v2;
+		WMOPS_UNCOUNT(shr);
 		return shr(v1, v2);
 	} else {
 		int32_t result;
 		result = (int32_t)v1 *((int32_t)1<< v2);
 
 		if((v2 > 15 && v1 != 0) || (result != (int32_t)((int16_t)result))) {
-			Overflow = true;
+			BASIC_OP_OVERFLOW();
 			return (v1 > 0)? INT16_MAX : INT16_MIN;
 		} else {
+			WMOPS_UNCOUNT(extract_l);
 			return extract_l(result);
 		}
 	}
@@ -152,9 +159,11 @@ int16_t shl(int16_t v1, int16_t v2)
 */
 int16_t shr(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(shr);
 	if(v2 < 0) {
 		if(v2 < -16) v2 = -16;
 		v2 = -v2;
+		WMOPS_UNCOUNT(shl);
 		return  shl(v1, v2);
 	} else {
 		if(v2 >= 15) {
@@ -171,6 +180,7 @@ int16_t shr(int16_t v1, int16_t v2)
 		}
 	}
 }
+#endif	/* BASIC_OP_INLINE */
 
 
 /**
@@ -190,6 +200,7 @@ int16_t shr(int16_t v1, int16_t v2)
 */
 int16_t norm_s(int16_t v1)
 {
+	WMOPS_COUNT(norm_s);
 	int16_t var_out;
 
 	if(v1 == 0) {
@@ -210,6 +221,7 @@ int16_t norm_s(int16_t v1)
 }
 
 
+#ifndef	BASIC_OP_INLINE
 /**
 * @brief	32 bits addition of the two 32 bits variables (L_v1+L_v2) 
 *			with overflow control and saturation; the result is set 
@@ -226,6 +238,7 @@ int16_t norm_s(int16_t v1)
 */
 int32_t L_add(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_add);
 	int32_t L_var_out;
 
 	L_var_out = L_v1 + L_v2;
@@ -233,7 +246,7 @@ int32_t L_add(int32_t L_v1, int32_t L_v2)
 	if(0 == (0x80000000L & (L_v1 ^ L_v2))) {	// When two sign bits are the same.
 		if(0x80000000L & (L_var_out ^ L_v1)) {	// But if the resulting sign bit is different. 
 			L_var_out = (L_v1 < 0)? INT32_MIN:INT32_MAX;
-			Overflow = true;
+			BASIC_OP_OVERFLOW();
 		}
 	}
 	return L_var_out;
@@ -256,6 +269,7 @@ int32_t L_add(int32_t L_v1, int32_t L_v2)
 */
 int32_t L_sub(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_sub);
 	int32_t L_var_out;
 
 	L_var_out = L_v1 - L_v2;
@@ -263,7 +277,7 @@ int32_t L_sub(int32_t L_v1, int32_t L_v2)
 	if(0 != (0x80000000L & (L_v1 ^ L_v2))) {	// When two sign bits are different.
 		if(0x80000000L & (L_var_out ^ L_v1)) {	// But if the resulting sign bit is different. 
 			L_var_out = (L_v1 < 0L)? INT32_MIN : INT32_MAX;
-			Overflow = true;
+			BASIC_OP_OVERFLOW();
 		}
 	}
 	return L_var_out;
@@ -287,22 +301,24 @@ int32_t L_sub(int32_t L_v1, int32_t L_v2)
 */
 int32_t L_shl(int32_t L_v1, int16_t v2)
 {
+	WMOPS_COUNT(L_shl);
 	int32_t L_var_out = 0L;
 
 	if(v2 <= 0) {
 		if(v2 < -32)
 			v2 = -32;
 		v2 = -v2;
+		WMOPS_UNCOUNT(L_shr);
 		L_var_out = L_shr(L_v1, v2);
 	} else {
 		for(; v2 > 0; v2--) {
 			if(L_v1 > (int32_t) 0X3fffffffL) {
-				Overflow = true;
+				BASIC_OP_OVERFLOW();
 				L_var_out = INT32_MAX;
 				break;
 			} else {
 				if(L_v1 < (int32_t) 0xc0000000L) {
-					Overflow = true;
+					BASIC_OP_OVERFLOW();
 					L_var_out = INT32_MIN;
 					break;
 				}
@@ -333,11 +349,13 @@ int32_t L_shl(int32_t L_v1, int16_t v2)
 */
 int32_t L_shr(int32_t L_v1, int16_t v2)
 {
+	WMOPS_COUNT(L_shr);
 	int32_t L_var_out;
 
 	if(v2 < 0) {
 		if(v2 < -32)	v2 = -32;
 		v2 = -v2;
+		WMOPS_UNCOUNT(L_shl);
 		L_var_out = L_shl(L_v1, v2);
 	} else {
 		if(v2 >= 31) {
@@ -352,6 +370,7 @@ int32_t L_shr(int32_t L_v1, int16_t v2)
 	}
 	return (L_var_out);
 }
+#endif	/* BASIC_OP_INLINE */
 
 /**
 * @brief	Produces the number of left shifts needed to normalize 
@@ -370,10 +389,11 @@ int32_t L_shr(int32_t L_v1, int16_t v2)
 */
 int16_t norm_l(int32_t L_v1)
 {
+	WMOPS_COUNT(norm_l);
 	if(L_v1 == 0) {
 		return 0;
 	} else {
-		if(INT32_MIN == L_v1) {
+		if(-1 == L_v1) {
 			return 31;
 		} else {
 			int16_t var_out;
@@ -390,6 +410,7 @@ int16_t norm_l(int32_t L_v1)
 }
 
 
+#ifndef	BASIC_OP_INLINE
 /**
 * @brief	L_mult is the-32 bit result of the multiplication of
 *			v1 times v2 with one shift left i.e.:
@@ -408,13 +429,14 @@ int16_t norm_l(int32_t L_v1)
 */
 int32_t L_mult(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_mult);
 	int32_t L_var_out;
 	L_var_out = (int32_t)v1 *(int32_t)v2;
 
 	if(L_var_out != 0x40000000L) {
 		L_var_out <<= 1;
 	} else {
-		Overflow = true;
+		BASIC_OP_OVERFLOW();
 		L_var_out = INT32_MAX;
 	}
 
@@ -437,6 +459,7 @@ int32_t L_mult(int16_t v1, int16_t v2)
 */
 int32_t L_mult0(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_mult0);
 	return	(int32_t)v1*(int32_t)v2;
 }
 
@@ -458,14 +481,17 @@ int32_t L_mult0(int16_t v1, int16_t v2)
 */
 int16_t mult(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(mult);
 	int32_t acc;
 
 	if((-32768 == v1) && (-32768 == v2)) {
+		BASIC_OP_OVERFLOW();
 		return INT16_MAX;
 	}
 	acc = (int32_t)v1*(int32_t)v2;
 	acc <<= 1;
 
+	WMOPS_UNCOUNT(extract_h);
 	return extract_h(acc);
 }
 
@@ -486,6 +512,7 @@ int16_t mult(int16_t v1, int16_t v2)
 */
 int16_t mult_r(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(mult_r);
 	int16_t var_out;
 	int32_t L_product_arr;
 
@@ -521,6 +548,9 @@ int16_t mult_r(int16_t v1, int16_t v2)
 */
 int32_t L_mac(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_mac);
+	WMOPS_UNCOUNT(L_add);
+	WMOPS_UNCOUNT(L_mult);
 	return L_add(L_v3, L_mult(v1, v2));
 }
 
@@ -544,8 +574,12 @@ int32_t L_mac(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int32_t L_mac0(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_mac0);
+	WMOPS_UNCOUNT(L_add);
+	WMOPS_UNCOUNT(L_mult0);
 	return	L_add(L_v3, L_mult0(v1, v2));
 }
+#endif	/* BASIC_OP_INLINE */
 
 
 /**
@@ -568,10 +602,14 @@ int32_t L_mac0(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int32_t L_macNs(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_macNs);
+	WMOPS_UNCOUNT(L_add_c);
+	WMOPS_UNCOUNT(L_mult);
 	return L_add_c(L_v3, L_mult(v1, v2));
 }
 
 
+#ifndef	BASIC_OP_INLINE
 /**
 * @brief	Multiply v1 by v2 and shift the result left by 1.  Add the
 *			32 bit result to L_v3 with saturation. Round the LS 16 bits 
@@ -593,6 +631,9 @@ int32_t L_macNs(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int16_t mac_r(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(mac_r);
+	WMOPS_UNCOUNT(round_fx);
+	WMOPS_UNCOUNT(L_mac);
 	return	round_fx(L_mac(L_v3, v1, v2));
 }
 
@@ -616,6 +657,9 @@ int16_t mac_r(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int32_t L_msu(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_msu);
+	WMOPS_UNCOUNT(L_sub);
+	WMOPS_UNCOUNT(L_mult);
 	return L_sub(L_v3, L_mult(v1, v2));
 }
 
@@ -639,8 +683,12 @@ int32_t L_msu(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int32_t L_msu0(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(L_msu0);
+	WMOPS_UNCOUNT(L_sub);
+	WMOPS_UNCOUNT(L_mult0);
 	return	L_sub(L_v3, L_mult0(v1, v2));
 }
+#endif	/* BASIC_OP_INLINE */
 
 
 /**
@@ -662,10 +710,14 @@ int32_t L_msu0(int32_t L_v3, int16_t v1, int16_t v2)
 *			in the range : 0x8000 0000 <= return value <= 0x7fff ffff.
 */
 int32_t L_msuNs(int32_t L_v3, int16_t v1, int16_t v2) {
+	WMOPS_COUNT(L_msuNs);
+	WMOPS_UNCOUNT(L_sub_c);
+	WMOPS_UNCOUNT(L_mult);
   return L_sub_c(L_v3, L_mult(v1, v2));
 }
 
 
+#ifndef	BASIC_OP_INLINE
 /**
 * @brief	Multiply v1 by v2 and shift the result left by 1. Subtracts
 *			the 32-bit result from L_v3 with saturation.
@@ -687,6 +739,9 @@ int32_t L_msuNs(int32_t L_v3, int16_t v1, int16_t v2) {
 */
 int16_t msu_r(int32_t L_v3, int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(msu_r);
+	WMOPS_UNCOUNT(round_fx);
+	WMOPS_UNCOUNT(L_msu);
 	return round_fx(L_msu(L_v3, v1, v2));
 }
 
@@ -704,8 +759,12 @@ int16_t msu_r(int32_t L_v3, int16_t v1, int16_t v2)
 */
 int16_t round_fx(int32_t L_v1)
 {
+	WMOPS_COUNT(round_fx);
+	WMOPS_UNCOUNT(extract_h);
+	WMOPS_UNCOUNT(L_add);
 	return extract_h(L_add(L_v1, 0x00008000L));
 }
+#endif	/* BASIC_OP_INLINE */
 
 
 /**
@@ -729,13 +788,15 @@ int16_t round_fx(int32_t L_v1)
 */
 int32_t L_add_c(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_add_c);
 	int32_t L_var_out;
 	int32_t L_test;
 	int carry_int = 0;
 
-	L_var_out = L_v1 + L_v2 + Carry;
+	// Wrap around in unsigned, a signed overflow is undefined in C.
+	L_var_out = (int32_t)((uint32_t)L_v1 + (uint32_t)L_v2 + (uint32_t)Carry);
 
-	L_test = L_v1 + L_v2;
+	L_test = (int32_t)((uint32_t)L_v1 + (uint32_t)L_v2);
 
 	if((L_v1 > 0) && (L_v2 > 0) && (L_test < 0)) {
 		Overflow = true;
@@ -801,6 +862,7 @@ int32_t L_add_c(int32_t L_v1, int32_t L_v2)
 */
 int32_t L_sub_c(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_sub_c);
 	int32_t L_var_out;
 	int32_t L_test;
 	int carry_int = 0;
@@ -808,17 +870,18 @@ int32_t L_sub_c(int32_t L_v1, int32_t L_v2)
 	if(Carry) {
 		Carry = 0;
 		if(L_v2 != INT32_MIN) {
+			WMOPS_UNCOUNT(L_add_c);
 			L_var_out = L_add_c(L_v1, -L_v2);
 		} else {
-			L_var_out = L_v1 - L_v2;
+			L_var_out = (int32_t)((uint32_t)L_v1 - (uint32_t)L_v2);
 			if(L_v1 > 0L) {
 				Overflow = true;
 				Carry = 0;
 			}
 		}
 	} else {
-		L_var_out = L_v1 - L_v2 - 0x00000001L;
-		L_test = L_v1 - L_v2;
+		L_var_out = (int32_t)((uint32_t)L_v1 - (uint32_t)L_v2 - 1u);
+		L_test = (int32_t)((uint32_t)L_v1 - (uint32_t)L_v2);
 
 		if((L_test < 0) && (L_v1 > 0) && (L_v2 < 0)) {
 			Overflow = true;
@@ -865,11 +928,13 @@ int32_t L_sub_c(int32_t L_v1, int32_t L_v2)
 */
 int16_t shr_r(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(shr_r);
 	int16_t var_out;
 
 	if(v2 > 15) {
 		var_out = 0;
 	} else {
+		WMOPS_UNCOUNT(shr);
 		var_out = shr(v1, v2);
 
 		if(v2 > 0) {
@@ -907,11 +972,13 @@ int16_t shr_r(int16_t v1, int16_t v2)
 */
 int32_t L_shr_r(int32_t L_v1, int16_t v2)
 {
+	WMOPS_COUNT(L_shr_r);
 	int32_t L_var_out;
 
 	if(v2 > 31) {
 		L_var_out = 0;
 	} else {
+		WMOPS_UNCOUNT(L_shr);
 		L_var_out = L_shr(L_v1, v2);
 
 		if(v2 > 0) {
@@ -937,6 +1004,7 @@ int32_t L_shr_r(int32_t L_v1, int16_t v2)
 */
 int16_t i_mult(int16_t a, int16_t b)
 {
+	WMOPS_COUNT(i_mult);
 #ifdef ORIGINAL_G7231
 	return a * b;
 #else
@@ -961,6 +1029,7 @@ int16_t i_mult(int16_t a, int16_t b)
 */
 int32_t L_sat(int32_t L_v1)
 {
+	WMOPS_COUNT(L_sat);
 	int32_t L_var_out;
 	L_var_out = L_v1;
 
@@ -999,6 +1068,10 @@ int32_t L_sat(int32_t L_v1)
 */
 int32_t L_mls(int32_t Lv, int16_t v)
 {
+	WMOPS_COUNT(L_mls);
+	WMOPS_UNCOUNT(L_shr);
+	WMOPS_UNCOUNT(L_mac);
+	WMOPS_UNCOUNT(extract_h);
 	int32_t acc;
 
 	acc = Lv & 0x0000ffffL;
@@ -1028,6 +1101,7 @@ int32_t L_mls(int32_t Lv, int16_t v)
 */
 int16_t div_s(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(div_s);
 	int16_t var_out = 0;
 	int32_t L_num;
 	int32_t L_denom;
@@ -1042,6 +1116,8 @@ int16_t div_s(int16_t v1, int16_t v2)
 		if(v1 == v2) {
 			var_out = INT16_MAX;
 		} else {
+			WMOPS_UNCOUNT(L_deposit_l);
+			WMOPS_UNCOUNT(L_deposit_l);
 			L_num = L_deposit_l(v1);
 			L_denom = L_deposit_l(v2);
 
@@ -1051,6 +1127,8 @@ int16_t div_s(int16_t v1, int16_t v2)
 				L_num <<= 1;
 
 				if(L_num >= L_denom) {
+					WMOPS_UNCOUNT(L_sub);
+					WMOPS_UNCOUNT(add);
 					L_num = L_sub(L_num, L_denom);
 					var_out = add(var_out, 1);
 				}
@@ -1081,6 +1159,7 @@ int16_t div_s(int16_t v1, int16_t v2)
 */
 int16_t div_l(int32_t L_num, int16_t den)
 {
+	WMOPS_COUNT(div_l);
 	int32_t L_den;
 	int16_t iteration;
 
@@ -1088,18 +1167,25 @@ int16_t div_l(int32_t L_num, int16_t den)
 	assert(0 <  den);
 	assert(0 <= L_num);
 
+	WMOPS_UNCOUNT(L_deposit_h);
 	L_den = L_deposit_h(den);
 
 	if(L_num >= L_den) {
 		return INT16_MAX;
 	} else {
 		int16_t var_out = 0;
+		WMOPS_UNCOUNT(L_shr);
+		WMOPS_UNCOUNT(L_shr);
 		L_num = L_shr(L_num, (int16_t) 1);
 		L_den = L_shr(L_den, (int16_t) 1);
 		for(iteration = (int16_t) 0; iteration < (int16_t) 15; iteration++) {
+			WMOPS_UNCOUNT(shl);
+			WMOPS_UNCOUNT(L_shl);
 			var_out = shl(var_out, (int16_t) 1);
 			L_num = L_shl(L_num, (int16_t) 1);
 			if(L_num >= L_den) {
+				WMOPS_UNCOUNT(L_sub);
+				WMOPS_UNCOUNT(add);
 				L_num = L_sub(L_num, L_den);
 				var_out = add(var_out, (int16_t) 1);
 			}
@@ -1113,28 +1199,501 @@ int16_t div_l(int32_t L_num, int16_t den)
 *	Module Debug 
 -------------------------------------------------------------------------------*/
 #ifdef MODULE_DEBUG
-
+/*
+*	Host test of the Basic Operators.
+*
+*	Every operator is compared with a 64 bit reference implementation of the
+*	ITU-T G.191 STL definition, including the Overflow and Carry side effects,
+*	over exhaustive (16 bit unary operators) or randomized inputs mixed with
+*	edge values. Then the throughput of the operator and of the reference is
+*	measured.
+*
+*	e.g.	gcc -O2 -DMODULE_DEBUG basic_op.c wmops.c -o basic_op && ./basic_op
+*			./basic_op 12345678 4000		: Print L_mls(0x12345678, 0x4000).
+*/
 #include <stdio.h>
+#include <time.h>
 
-int main(int argc, char* argv[])
+#define	NUMOF_VECTORS	65536
+#define	NUMOF_ROUNDS	64				// Randomized vectors = NUMOF_VECTORS*NUMOF_ROUNDS
+#define	NUMOF_BENCH		16				// Repeat of the vectors for the throughput.
+#define	MAX_REPORTS		4				// Mismatches printed per operator.
+
+/*-------------------------------------------------------------------------------
+*	Reference implementation
+-------------------------------------------------------------------------------*/
+static bool ref_Overflow;
+static int ref_Carry;
+
+// Saturating operators don't set Overflow with BASIC_OP_NO_OVERFLOW.
+#ifdef	BASIC_OP_NO_OVERFLOW
+	#define	REF_OVERFLOW()	((void)0)
+#else
+	#define	REF_OVERFLOW()	(ref_Overflow = true)
+#endif
+
+static int32_t ref_wrap32(int64_t x)
+{
+	return (int32_t)(uint32_t)(uint64_t)x;
+}
+
+static int64_t ref_floor_shr(int64_t x, int s)
+{
+	int64_t d = (int64_t)1<<s;
+	return (0 <= x)? x/d : -((-x + d - 1)/d);
+}
+
+static int16_t ref_sat16(int64_t x)
+{
+	if(INT16_MAX < x) {
+		REF_OVERFLOW();
+		return INT16_MAX;
+	} else if(x < INT16_MIN) {
+		REF_OVERFLOW();
+		return INT16_MIN;
+	}
+	return (int16_t)x;
+}
+
+static int32_t ref_sat32(int64_t x)
 {
-	int32_t var[5];
+	if(INT32_MAX < x) {
+		REF_OVERFLOW();
+		return INT32_MAX;
+	} else if(x < INT32_MIN) {
+		REF_OVERFLOW();
+		return INT32_MIN;
+	}
+	return (int32_t)x;
+}
 
-	for(int i = 0; i < argc; i++) {
-		if(0 < i) {
-			sscanf(argv[i], "%x\n", &var[i - 1]); 
+static int16_t ref_norm(int64_t x, int bits)
+{
+	if(0 == x) {
+		return 0;
+	} else if(-1 == x) {
+		return bits - 1;
+	}
+	if(x < 0) {
+		x = -x - 1;
+	}
+	int msb = 0;
+	while(1 < (x>>msb)) {
+		msb++;
+	}
+	return bits - 2 - msb;
+}
+
+static int16_t ref_shr(int16_t v1, int16_t v2);
+static int32_t ref_L_shr(int32_t L_v1, int16_t v2);
+
+static int16_t ref_saturate(int32_t L_v1)		{ return ref_sat16(L_v1); }
+static int16_t ref_add(int16_t v1, int16_t v2)	{ return ref_sat16((int64_t)v1 + v2); }
+static int16_t ref_sub(int16_t v1, int16_t v2)	{ return ref_sat16((int64_t)v1 - v2); }
+static int16_t ref_abs_s(int16_t v1)			{ return (INT16_MIN == v1)? INT16_MAX : (v1 < 0)? -v1 : v1; }
+static int16_t ref_negate(int16_t v1)			{ return (INT16_MIN == v1)? INT16_MAX : -v1; }
+static int16_t ref_extract_h(int32_t L_v1)		{ return (int16_t)ref_floor_shr(L_v1, 16); }
+static int16_t ref_extract_l(int32_t L_v1)		{ return (int16_t)(L_v1 - ref_floor_shr(L_v1, 16)*65536 - ((L_v1 & 0x8000)? 65536 : 0)); }
+static int32_t ref_L_deposit_h(int16_t v1)		{ return (int32_t)((int64_t)v1*65536); }
+static int32_t ref_L_deposit_l(int16_t v1)		{ return v1; }
+static int16_t ref_norm_s(int16_t v1)			{ return ref_norm(v1, 16); }
+static int16_t ref_norm_l(int32_t L_v1)			{ return ref_norm(L_v1, 32); }
+static int16_t ref_s_max(int16_t v1, int16_t v2)	{ return (v1 > v2)? v1 : v2; }
+static int16_t ref_s_min(int16_t v1, int16_t v2)	{ return (v1 < v2)? v1 : v2; }
+static int32_t ref_L_max(int32_t L_v1, int32_t L_v2)	{ return (L_v1 > L_v2)? L_v1 : L_v2; }
+static int32_t ref_L_min(int32_t L_v1, int32_t L_v2)	{ return (L_v1 < L_v2)? L_v1 : L_v2; }
+static int32_t ref_L_add(int32_t L_v1, int32_t L_v2)	{ return ref_sat32((int64_t)L_v1 + L_v2); }
+static int32_t ref_L_sub(int32_t L_v1, int32_t L_v2)	{ return ref_sat32((int64_t)L_v1 - L_v2); }
+static int32_t ref_L_negate(int32_t L_v1)		{ return (INT32_MIN == L_v1)? INT32_MAX : -L_v1; }
+static int32_t ref_L_abs(int32_t L_v1)			{ return (INT32_MIN == L_v1)? INT32_MAX : (L_v1 < 0)? -L_v1 : L_v1; }
+static int16_t ref_mult(int16_t v1, int16_t v2)	{ return ref_sat16(ref_floor_shr((int64_t)v1*v2, 15)); }
+static int16_t ref_mult_r(int16_t v1, int16_t v2)	{ return ref_sat16(ref_floor_shr((int64_t)v1*v2 + 0x4000, 15)); }
+static int16_t ref_i_mult(int16_t v1, int16_t v2)	{ return ref_sat16((int64_t)v1*v2); }
+static int32_t ref_L_mult0(int16_t v1, int16_t v2)	{ return (int32_t)v1*v2; }
+static int32_t ref_L_mult(int16_t v1, int16_t v2)	{ return ref_sat32(2*(int64_t)v1*v2); }
+static int32_t ref_L_mac(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_L_add(L_v3, ref_L_mult(v1, v2)); }
+static int32_t ref_L_msu(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_L_sub(L_v3, ref_L_mult(v1, v2)); }
+static int32_t ref_L_mac0(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_sat32((int64_t)L_v3 + (int64_t)v1*v2); }
+static int32_t ref_L_msu0(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_sat32((int64_t)L_v3 - (int64_t)v1*v2); }
+static int16_t ref_round_fx(int32_t L_v1)		{ return ref_extract_h(ref_sat32((int64_t)L_v1 + 0x8000)); }
+static int16_t ref_mac_r(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_round_fx(ref_L_mac(L_v3, v1, v2)); }
+static int16_t ref_msu_r(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_round_fx(ref_L_msu(L_v3, v1, v2)); }
+
+static int16_t ref_shl(int16_t v1, int16_t v2)
+{
+	if(v2 < 0) {
+		return ref_shr(v1, (v2 < -16)? 16 : -v2);
+	} else if(0 == v1) {
+		return 0;
+	} else if(15 < v2) {
+		REF_OVERFLOW();
+		return (0 < v1)? INT16_MAX : INT16_MIN;
+	}
+	return ref_sat16((int64_t)v1*((int64_t)1<<v2));
+}
+
+static int16_t ref_shr(int16_t v1, int16_t v2)
+{
+	if(v2 < 0) {
+		return ref_shl(v1, (v2 < -16)? 16 : -v2);
+	}
+	return (int16_t)ref_floor_shr(v1, (15 < v2)? 15 : v2);
+}
+
+static int32_t ref_L_shl(int32_t L_v1, int16_t v2)
+{
+	if(v2 <= 0) {
+		return ref_L_shr(L_v1, (v2 < -32)? 32 : -v2);
+	} else if(0 == L_v1) {
+		return 0;
+	} else if(31 < v2) {
+		REF_OVERFLOW();
+		return (0 < L_v1)? INT32_MAX : INT32_MIN;
+	}
+	return ref_sat32((int64_t)L_v1*((int64_t)1<<v2));
+}
+
+static int32_t ref_L_shr(int32_t L_v1, int16_t v2)
+{
+	if(v2 < 0) {
+		return ref_L_shl(L_v1, (v2 < -32)? 32 : -v2);
+	}
+	return (int32_t)ref_floor_shr(L_v1, (31 < v2)? 31 : v2);
+}
+
+static int16_t ref_shr_r(int16_t v1, int16_t v2)
+{
+	if(15 < v2) {
+		return 0;
+	}
+	int16_t var_out = ref_shr(v1, v2);
+	if(0 < v2) {
+		var_out += ref_floor_shr(v1, v2 - 1) & 1;
+	}
+	return var_out;
+}
+
+static int32_t ref_L_shr_r(int32_t L_v1, int16_t v2)
+{
+	if(31 < v2) {
+		return 0;
+	}
+	int32_t L_var_out = ref_L_shr(L_v1, v2);
+	if(0 < v2) {
+		L_var_out += ref_floor_shr(L_v1, v2 - 1) & 1;
+	}
+	return L_var_out;
+}
+
+static int32_t ref_L_mls(int32_t Lv, int16_t v)
+{
+	int64_t lo = ref_floor_shr((int64_t)(Lv & 0xffff)*v, 15);
+	return ref_L_add((int32_t)lo, ref_L_mult(v, ref_extract_h(Lv)));
+}
+
+static int16_t ref_div_s(int16_t v1, int16_t v2)
+{
+	return (v1 == v2)? INT16_MAX : (int16_t)(((int64_t)v1<<15)/v2);
+}
+
+static int16_t ref_div_l(int32_t L_num, int16_t den)
+{
+	return (((int64_t)den<<16) <= L_num)? INT16_MAX : (int16_t)((L_num>>1)/den);
+}
+
+/*
+*	Carry operators. The STL defines them by its code, so the quirks are kept:
+*	L_add_c() reports the overflow of L_v1 + L_v2 (not including the carry in)
+*	and also when the sum is INT32_MAX with the carry in. L_sub_c() leaves
+*	Overflow untouched in some cases.
+*/
+static int32_t ref_L_add_c(int32_t L_v1, int32_t L_v2)
+{
+	int64_t sum = (int64_t)L_v1 + L_v2;
+	uint64_t usum = (uint64_t)(uint32_t)L_v1 + (uint32_t)L_v2 + (uint32_t)ref_Carry;
+	int32_t L_var_out = ref_wrap32(sum + ref_Carry);
+
+	ref_Overflow = (INT32_MAX < sum) || (sum < INT32_MIN) || (ref_Carry && (INT32_MAX == ref_wrap32(sum)));
+	ref_Carry = (int)(usum>>32);
+	return L_var_out;
+}
+
+static int32_t ref_L_sub_c(int32_t L_v1, int32_t L_v2)
+{
+	int64_t diff = (int64_t)L_v1 - L_v2;
+
+	if(ref_Carry) {
+		ref_Carry = 0;
+		if(INT32_MIN != L_v2) {
+			return ref_L_add_c(L_v1, -L_v2);
+		}
+		if(0 < L_v1) {
+			ref_Overflow = true;
 		}
+		return ref_wrap32(diff);
 	}
 
-	for(int i = 0; i < argc - 1; i++) {
-		//	printf("%x\n", var[i]);
+	int carry = 0;
+	if((INT32_MAX < diff) && (0 < L_v1)) {
+		ref_Overflow = true;
+	} else if(diff < INT32_MIN) {
+		ref_Overflow = true;
+		carry = 1;
+	} else if((0 < diff) && (0 < (L_v1 ^ L_v2))) {
+		ref_Overflow = false;
+		carry = 1;
 	}
+	if(INT32_MIN == ref_wrap32(diff)) {
+		ref_Overflow = true;
+	}
+	ref_Carry = carry;
+	return ref_wrap32(diff - 1);
+}
 
-	printf("L_mls=%x\n", L_mls(var[0], var[1]));
-	
-	return 0;
+static int32_t ref_L_macNs(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_L_add_c(L_v3, ref_L_mult(v1, v2)); }
+static int32_t ref_L_msuNs(int32_t L_v3, int16_t v1, int16_t v2)	{ return ref_L_sub_c(L_v3, ref_L_mult(v1, v2)); }
+
+static int32_t ref_L_sat(int32_t L_v1)
+{
+	if(ref_Overflow) {
+		L_v1 = (ref_Carry)? INT32_MIN : INT32_MAX;
+		ref_Carry = 0;
+		ref_Overflow = false;
+	}
+	return L_v1;
 }
-#endif
+
+/*-------------------------------------------------------------------------------
+*	Test vectors
+-------------------------------------------------------------------------------*/
+typedef enum {
+	GEN_NONE = 0,
+	GEN_SEQ,			// All of the 16 bit values. (exhaustive)
+	GEN_S,				// 16 bit
+	GEN_L,				// 32 bit
+	GEN_SHIFT,			// Shift count of the 16 bit operators.
+	GEN_L_SHIFT,		// Shift count of the 32 bit operators.
+	GEN_DEN,			// 1 <= den <= INT16_MAX
+	GEN_DIV_S,			// 0 <= num <= den
+	GEN_DIV_L,			// 0 <= L_num <= (den<<16)
+} GEN_TYPE;
+
+static int32_t va[NUMOF_VECTORS];
+static int32_t vb[NUMOF_VECTORS];
+static int32_t vc[NUMOF_VECTORS];
+
+static uint64_t rnd_state = 0x3243F6A8885A308DULL;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state<<13;
+	rnd_state ^= rnd_state>>7;
+	rnd_state ^= rnd_state<<17;
+	return (uint32_t)(rnd_state>>16);
+}
+
+static int32_t gen(GEN_TYPE type, int i)
+{
+	static const int16_t edge_s[] = {
+		0, 1, -1, 2, -2, INT16_MAX, INT16_MIN, INT16_MAX - 1, INT16_MIN + 1, 0x4000, -0x4000, 0x3fff, -0x4001,
+	};
+	static const int32_t edge_l[] = {
+		0, 1, -1, 2, -2, INT32_MAX, INT32_MIN, INT32_MAX - 1, INT32_MIN + 1, 0x40000000, -0x40000000,
+		0x3fffffff, -0x40000001, 0x7fff8000, 0x7fff7fff, 0x8000, 0x7fff, -0x8000, 0xffff, 0x10000,
+	};
+	static const int16_t edge_shift[] = {
+		INT16_MIN, -33, -32, -31, -17, -16, -15, -1, 0, 1, 14, 15, 16, 30, 31, 32, 33,
+	};
+	uint32_t r = rnd();
+
+	switch(type) {
+	case GEN_SEQ:
+		return (int16_t)i;
+	case GEN_S:
+		switch(r & 7) {
+		case 0:		return edge_s[(r>>3) % (sizeof(edge_s)/sizeof(edge_s[0]))];
+		case 1:		return (int16_t)((r>>16) & 0xff) - 128;
+		default:	return (int16_t)(r>>16);
+		}
+	case GEN_L:
+		switch(r & 7) {
+		case 0:		return edge_l[(r>>3) % (sizeof(edge_l)/sizeof(edge_l[0]))];
+		case 1:		return (int32_t)((r>>16) & 0xffff) - 32768;
+		case 2:		return INT32_MAX - (int32_t)(rnd() & 0xffff);
+		case 3:		return INT32_MIN + (int32_t)(rnd() & 0xffff);
+		default:	return (int32_t)rnd();
+		}
+	case GEN_SHIFT:
+	case GEN_L_SHIFT:
+		if(0 == (r & 3)) {
+			int16_t s = edge_shift[(r>>2) % (sizeof(edge_shift)/sizeof(edge_shift[0]))];
+			return (GEN_SHIFT == type && 31 < s)? 31 : s;		// (1<<32) of shl() is undefined.
+		}
+		return (int32_t)((r>>8) % 72) - 40;
+	case GEN_DEN:
+		return 1 + (int32_t)((r>>8) % INT16_MAX);
+	case GEN_DIV_S:
+		return (int32_t)(((uint64_t)rnd()*(vb[i] + 1))>>32);
+	case GEN_DIV_L:
+		return (int32_t)(((uint64_t)rnd()*(((uint64_t)vb[i]<<16) + 1))>>32);
+	default:
+		return 0;
+	}
+}
+
+/**
+* @return	true if the vectors are randomized.
+*/
+static bool fill_vectors(GEN_TYPE ga, GEN_TYPE gb, GEN_TYPE gc)
+{
+	for(int i = 0; i < NUMOF_VECTORS; i++) {
+		vc[i] = gen(gc, i);
+		vb[i] = gen(gb, i);
+		va[i] = gen(ga, i);
+	}
+	return (GEN_SEQ != ga) || (GEN_NONE != gb) || (GEN_NONE != gc);
+}
+
+/*-------------------------------------------------------------------------------
+*	Test runner
+-------------------------------------------------------------------------------*/
+#define	SA		((int16_t)va[i])
+#define	SB		((int16_t)vb[i])
+#define	SC		((int16_t)vc[i])
+#define	LA		(va[i])
+
+static int total_fails = 0;
+static volatile int32_t bench_sink;
+
+static double elapsed_ns(const struct timespec* t0, const struct timespec* t1)
+{
+	return (t1->tv_sec - t0->tv_sec)*1e9 + (t1->tv_nsec - t0->tv_nsec);
+}
+
+static void report(const char* name, int fails, long tests, double ns_op, double ns_ref)
+{
+	printf("%-12s %10ld tests %6d fails %8.3f ns/op (reference %8.3f ns/op)\n", name, tests, fails, ns_op, ns_ref);
+	total_fails += fails;
+}
+
+#define	TEST_OP(name, ga, gb, gc, call, ref_call)								\
+	do {																				\
+		int fails = 0;																	\
+		long tests = 0;																	\
+		for(int round = 0; round < NUMOF_ROUNDS; round++) {								\
+			bool randomized = fill_vectors(ga, gb, gc);									\
+			for(int i = 0; i < NUMOF_VECTORS; i++, tests++) {							\
+				Overflow = ref_Overflow = (i & 1);										\
+				Carry = ref_Carry = (i>>1) & 1;											\
+				int32_t r = (call);														\
+				bool r_ovf = Overflow;													\
+				int r_carry = Carry;													\
+				int32_t e = (ref_call);													\
+				if((r != e) || (r_ovf != ref_Overflow) || (r_carry != ref_Carry)) {	\
+					if(fails++ < MAX_REPORTS) {											\
+						printf("%s(%08x, %08x, %08x): %08x ovf=%d carry=%d, expected %08x ovf=%d carry=%d\n",	\
+							name, (unsigned)va[i], (unsigned)vb[i], (unsigned)vc[i],	\
+							(unsigned)r, r_ovf, r_carry, (unsigned)e, ref_Overflow, ref_Carry);	\
+					}																	\
+				}																		\
+			}																			\
+			if(!randomized) {															\
+				break;																	\
+			}																			\
+		}																				\
+																						\
+		struct timespec t0, t1, t2;														\
+		int32_t sink = 0;																\
+		clock_gettime(CLOCK_MONOTONIC, &t0);											\
+		for(int rep = 0; rep < NUMOF_BENCH; rep++) {									\
+			for(int i = 0; i < NUMOF_VECTORS; i++) {									\
+				sink ^= (call);															\
+			}																			\
+		}																				\
+		clock_gettime(CLOCK_MONOTONIC, &t1);											\
+		for(int rep = 0; rep < NUMOF_BENCH; rep++) {									\
+			for(int i = 0; i < NUMOF_VECTORS; i++) {									\
+				sink ^= (ref_call);														\
+			}																			\
+		}																				\
+		clock_gettime(CLOCK_MONOTONIC, &t2);											\
+		bench_sink = sink;																\
+																						\
+		report(name, fails, tests,														\
+			elapsed_ns(&t0, &t1)/((double)NUMOF_BENCH*NUMOF_VECTORS),					\
+			elapsed_ns(&t1, &t2)/((double)NUMOF_BENCH*NUMOF_VECTORS));					\
+	} while(0)
+
+#define	TEST(op, ga, gb, gc, ...)		TEST_OP(#op, ga, gb, gc, op(__VA_ARGS__), ref_##op(__VA_ARGS__))
+
+
+int main(int argc, char* argv[])
+{
+	if(1 < argc) {
+		int32_t var[5] = { 0 };
+
+		for(int i = 1; (i < argc) && (i <= 5); i++) {
+			sscanf(argv[i], "%x", (unsigned int*)&var[i - 1]);
+		}
+		printf("L_mls=%x\n", L_mls(var[0], (int16_t)var[1]));
+
+		return 0;
+	}
+
+	TEST(saturate,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(add,			GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(sub,			GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(abs_s,			GEN_SEQ,	GEN_NONE,	GEN_NONE,	SA);
+	TEST(negate,		GEN_SEQ,	GEN_NONE,	GEN_NONE,	SA);
+	TEST(shl,			GEN_S,		GEN_SHIFT,	GEN_NONE,	SA, SB);
+	TEST(shr,			GEN_S,		GEN_SHIFT,	GEN_NONE,	SA, SB);
+	TEST(shr_r,			GEN_S,		GEN_SHIFT,	GEN_NONE,	SA, SB);
+	TEST(mult,			GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(mult_r,		GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(i_mult,		GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(s_max,			GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(s_min,			GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(norm_s,		GEN_SEQ,	GEN_NONE,	GEN_NONE,	SA);
+	TEST(div_s,			GEN_DIV_S,	GEN_DEN,	GEN_NONE,	SA, SB);
+
+	TEST(extract_h,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(extract_l,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(round_fx,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(norm_l,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(L_deposit_h,	GEN_SEQ,	GEN_NONE,	GEN_NONE,	SA);
+	TEST(L_deposit_l,	GEN_SEQ,	GEN_NONE,	GEN_NONE,	SA);
+
+	TEST(L_add,			GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_sub,			GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_negate,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(L_abs,			GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+	TEST(L_max,			GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_min,			GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_shl,			GEN_L,		GEN_L_SHIFT,GEN_NONE,	LA, SB);
+	TEST(L_shr,			GEN_L,		GEN_L_SHIFT,GEN_NONE,	LA, SB);
+	TEST(L_shr_r,		GEN_L,		GEN_L_SHIFT,GEN_NONE,	LA, SB);
+	TEST(L_mult,		GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(L_mult0,		GEN_S,		GEN_S,		GEN_NONE,	SA, SB);
+	TEST(L_mac,			GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_msu,			GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_mac0,		GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_msu0,		GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(mac_r,			GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(msu_r,			GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_mls,			GEN_L,		GEN_S,		GEN_NONE,	LA, SB);
+	TEST(div_l,			GEN_DIV_L,	GEN_DEN,	GEN_NONE,	LA, SB);
+
+	TEST(L_add_c,		GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_sub_c,		GEN_L,		GEN_L,		GEN_NONE,	LA, vb[i]);
+	TEST(L_macNs,		GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_msuNs,		GEN_L,		GEN_S,		GEN_S,		LA, SB, SC);
+	TEST(L_sat,		GEN_L,		GEN_NONE,	GEN_NONE,	LA);
+
+	printf("%s: %d fails\n", (0 == total_fails)? "PASS" : "FAIL", total_fails);
+
+	return (0 == total_fails)? 0 : 1;
+}
+#endif	/* MODULE_DEBUG */
 /*==============================================================================
 *	End
 *===============================================================================*/
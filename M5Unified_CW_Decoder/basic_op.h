@@ -34,8 +34,70 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-extern bool Overflow;
-extern int Carry;
+#include "wmops.h"
+
+//******** Configurations ********************************************
+//--------	Inline the saturating operators in this header. ----------
+#define	BASIC_OP_INLINE
+
+//--------	Do not record Overflow in the saturating operators. -------
+// #define	BASIC_OP_NO_OVERFLOW
+//--------------------------------------------------------------------
+
+/**
+*	Overflow and Carry are thread-local, so pipelines running on different
+*	threads do not share them.
+*/
+#if defined(__AVR__)
+	#define	BASIC_OP_TLS		// No threads.
+#elif defined(__GNUC__)
+	#define	BASIC_OP_TLS		__thread
+#elif defined(__cplusplus)
+	#define	BASIC_OP_TLS		thread_local
+#else
+	#define	BASIC_OP_TLS		_Thread_local
+#endif
+
+extern BASIC_OP_TLS bool Overflow;
+extern BASIC_OP_TLS int Carry;
+
+/**
+* @brief	Overflow/Carry state owned by a pipeline.
+*/
+typedef struct {
+	bool Overflow;
+	int Carry;
+} BASIC_OP_CONTEXT;
+
+/**
+* @brief	Exchange the Overflow/Carry state of the calling thread with *ctx.
+*			Call it on entry and exit of a pipeline to run the pipeline on its own
+*			state and give the caller's state back.
+*
+* @param[in,out] ctx	Context owned by the pipeline.
+*/
+static inline void basic_op_swap_context(BASIC_OP_CONTEXT* ctx)
+{
+	bool ovf = Overflow;
+	int carry = Carry;
+
+	Overflow = ctx->Overflow;
+	Carry = ctx->Carry;
+	ctx->Overflow = ovf;
+	ctx->Carry = carry;
+}
+
+#ifdef	BASIC_OP_NO_OVERFLOW
+	#define	BASIC_OP_OVERFLOW()		((void)0)
+#else
+	#define	BASIC_OP_OVERFLOW()		(Overflow = true)
+#endif
+
+#if defined(__GNUC__)
+	#define	BASIC_OP_UNLIKELY(cond)		__builtin_expect(!!(cond), 0)
+#else
+	#define	BASIC_OP_UNLIKELY(cond)		(cond)
+#endif
 
 /**
 * @brief	Return the 16 MSB of L_v1.
@@ -48,6 +110,7 @@ extern int Carry;
 */
 static inline int16_t extract_h(int32_t L_v1)
 {
+	WMOPS_COUNT(extract_h);
 	return L_v1>>16;
 }
 
@@ -63,6 +126,7 @@ static inline int16_t extract_h(int32_t L_v1)
 */
 static inline int16_t extract_l(int32_t L_v1)
 {
+	WMOPS_COUNT(extract_l);
 	return (int16_t)L_v1;
 }
 
@@ -79,6 +143,7 @@ static inline int16_t extract_l(int32_t L_v1)
 */
 static inline int32_t L_deposit_h(int16_t v1)
 {
+	WMOPS_COUNT(L_deposit_h);
 	return (int32_t)v1<<16;
 }
 
@@ -95,6 +160,7 @@ static inline int32_t L_deposit_h(int16_t v1)
 */
 static inline int32_t L_deposit_l(int16_t v1)
 {
+	WMOPS_COUNT(L_deposit_l);
 	return (int32_t)v1;
 }
 
@@ -111,6 +177,7 @@ static inline int32_t L_deposit_l(int16_t v1)
 */
 static inline int16_t negate(int16_t v1)
 {
+	WMOPS_COUNT(negate);
 	return (v1 == INT16_MIN)? INT16_MAX : -v1;
 }
 
@@ -127,6 +194,7 @@ static inline int16_t negate(int16_t v1)
 */
 static inline int32_t L_negate(int32_t L_v1)
 {
+	WMOPS_COUNT(L_negate);
 	return (INT32_MIN == L_v1)? INT32_MAX : -L_v1;
 }
 
@@ -142,6 +210,7 @@ static inline int32_t L_negate(int32_t L_v1)
 */
 static inline int16_t abs_s(int16_t v1)
 {
+	WMOPS_COUNT(abs_s);
 	if(INT16_MIN == v1) {
 		return INT16_MAX;
 	} else {
@@ -161,6 +230,7 @@ static inline int16_t abs_s(int16_t v1)
 */
 static inline int32_t L_abs(int32_t L_v1)
 {
+	WMOPS_COUNT(L_abs);
 	if(L_v1 == INT32_MIN) {
 		return INT32_MAX;
 	} else {
@@ -179,30 +249,280 @@ static inline int32_t L_abs(int32_t L_v1)
 */
 static inline int16_t s_max(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(s_max);
 	return (v1 > v2)? v1 : v2;
 }
 
 static inline int16_t s_min(int16_t v1, int16_t v2)
 {
+	WMOPS_COUNT(s_min);
 	return (v1 < v2)? v1 : v2;
 }
 
 static inline int32_t L_max(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_max);
 	return (L_v1 > L_v2)? L_v1 : L_v2;
 }
 
 static inline int32_t L_min(int32_t L_v1, int32_t L_v2)
 {
+	WMOPS_COUNT(L_min);
 	return (L_v1 < L_v2)? L_v1 : L_v2;
 }
 
 
+#ifdef	BASIC_OP_INLINE
+/*------------------------------------------------------------------------------
+*	Inlined saturating operators.
+*	Bit-exact with the out-of-line versions in basic_op.c, see there for details.
+------------------------------------------------------------------------------*/
+static inline int16_t shr(int16_t v1, int16_t v2);
+static inline int32_t L_shr(int32_t L_v1, int16_t v2);
+
+/**
+* @brief	Limit the 32 bit input to the range of a 16 bit word.
+*/
+static inline int16_t saturate(int32_t L_v1)
+{
+	if(BASIC_OP_UNLIKELY(L_v1 != (int16_t)L_v1)) {
+		BASIC_OP_OVERFLOW();
+		return (L_v1 < 0)? INT16_MIN : INT16_MAX;
+	}
+	return (int16_t)L_v1;
+}
+
+/**
+* @brief	Short add/sub with saturation.
+*/
+static inline int16_t add(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(add);
+	return saturate((int32_t)v1 + v2);
+}
+
+static inline int16_t sub(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(sub);
+	return saturate((int32_t)v1 - v2);
+}
+
+/**
+* @brief	Short arithmetic shift left/right with saturation.
+*/
+static inline int16_t shl(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(shl);
+	if(v2 < 0) {
+		WMOPS_UNCOUNT(shr);
+		return shr(v1, (v2 < -16)? 16 : -v2);
+	} else if(15 < v2) {
+		if(0 == v1) {
+			return 0;
+		}
+		BASIC_OP_OVERFLOW();
+		return (0 < v1)? INT16_MAX : INT16_MIN;
+	} else {
+		int32_t result = (int32_t)v1*((int32_t)1<<v2);
+
+		if(BASIC_OP_UNLIKELY(result != (int16_t)result)) {
+			BASIC_OP_OVERFLOW();
+			return (0 < v1)? INT16_MAX : INT16_MIN;
+		}
+		return (int16_t)result;
+	}
+}
+
+static inline int16_t shr(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(shr);
+	if(v2 < 0) {
+		WMOPS_UNCOUNT(shl);
+		return shl(v1, (v2 < -16)? 16 : -v2);
+	} else if(15 <= v2) {
+		return (v1 < 0)? -1 : 0;
+	} else {
+		return v1>>v2;
+	}
+}
+
+/**
+* @brief	Long add/sub with saturation.
+*/
+static inline int32_t L_add(int32_t L_v1, int32_t L_v2)
+{
+	WMOPS_COUNT(L_add);
+	int32_t L_var_out = (int32_t)((uint32_t)L_v1 + (uint32_t)L_v2);
+
+	// Overflow when both inputs have the same sign and the result has the other.
+	if(BASIC_OP_UNLIKELY(((L_v1 ^ L_var_out) & (L_v2 ^ L_var_out)) < 0)) {
+		BASIC_OP_OVERFLOW();
+		L_var_out = (L_v1 < 0)? INT32_MIN : INT32_MAX;
+	}
+	return L_var_out;
+}
+
+static inline int32_t L_sub(int32_t L_v1, int32_t L_v2)
+{
+	WMOPS_COUNT(L_sub);
+	int32_t L_var_out = (int32_t)((uint32_t)L_v1 - (uint32_t)L_v2);
+
+	// Overflow when the inputs have different signs and the result differs from L_v1.
+	if(BASIC_OP_UNLIKELY(((L_v1 ^ L_v2) & (L_v1 ^ L_var_out)) < 0)) {
+		BASIC_OP_OVERFLOW();
+		L_var_out = (L_v1 < 0)? INT32_MIN : INT32_MAX;
+	}
+	return L_var_out;
+}
+
+/**
+* @brief	Long arithmetic shift left/right with saturation.
+*/
+static inline int32_t L_shl(int32_t L_v1, int16_t v2)
+{
+	WMOPS_COUNT(L_shl);
+	if(v2 <= 0) {
+		WMOPS_UNCOUNT(L_shr);
+		return L_shr(L_v1, (v2 < -32)? 32 : -v2);
+	} else if(31 < v2) {
+		if(0 == L_v1) {
+			return 0;
+		}
+		BASIC_OP_OVERFLOW();
+		return (0 < L_v1)? INT32_MAX : INT32_MIN;
+	} else {
+		int32_t L_var_out = (int32_t)((uint32_t)L_v1<<v2);
+
+		if(BASIC_OP_UNLIKELY((L_var_out>>v2) != L_v1)) {
+			BASIC_OP_OVERFLOW();
+			return (0 < L_v1)? INT32_MAX : INT32_MIN;
+		}
+		return L_var_out;
+	}
+}
+
+static inline int32_t L_shr(int32_t L_v1, int16_t v2)
+{
+	WMOPS_COUNT(L_shr);
+	if(v2 < 0) {
+		WMOPS_UNCOUNT(L_shl);
+		return L_shl(L_v1, (v2 < -32)? 32 : -v2);
+	} else if(31 <= v2) {
+		return (L_v1 < 0)? -1 : 0;
+	} else {
+		return L_v1>>v2;
+	}
+}
+
+/**
+* @brief	Multiplications.
+*/
+static inline int32_t L_mult(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_mult);
+	int32_t L_var_out = (int32_t)v1*(int32_t)v2;
+
+	if(BASIC_OP_UNLIKELY(0x40000000L == L_var_out)) {
+		BASIC_OP_OVERFLOW();
+		return INT32_MAX;
+	}
+	return (int32_t)((uint32_t)L_var_out<<1);
+}
+
+static inline int32_t L_mult0(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_mult0);
+	return (int32_t)v1*(int32_t)v2;
+}
+
+static inline int16_t mult(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(mult);
+	if(BASIC_OP_UNLIKELY((INT16_MIN == v1) && (INT16_MIN == v2))) {
+		BASIC_OP_OVERFLOW();
+		return INT16_MAX;
+	}
+	return (int16_t)(((int32_t)v1*(int32_t)v2)>>15);
+}
+
+static inline int16_t mult_r(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(mult_r);
+	return saturate(((int32_t)v1*(int32_t)v2 + 0x00004000L)>>15);
+}
+
+/**
+* @brief	Round the lower 16 bits into the MS 16 bits with saturation.
+*/
+static inline int16_t round_fx(int32_t L_v1)
+{
+	WMOPS_COUNT(round_fx);
+	if(BASIC_OP_UNLIKELY(0x7FFF7FFFL < L_v1)) {
+		BASIC_OP_OVERFLOW();
+		return INT16_MAX;
+	}
+	return (int16_t)((L_v1 + 0x00008000L)>>16);
+}
+
+/**
+* @brief	Multiply-accumulate/subtract.
+*/
+static inline int32_t L_mac(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_mac);
+	WMOPS_UNCOUNT(L_add);
+	WMOPS_UNCOUNT(L_mult);
+	return L_add(L_v3, L_mult(v1, v2));
+}
+
+static inline int32_t L_msu(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_msu);
+	WMOPS_UNCOUNT(L_sub);
+	WMOPS_UNCOUNT(L_mult);
+	return L_sub(L_v3, L_mult(v1, v2));
+}
+
+static inline int32_t L_mac0(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_mac0);
+	WMOPS_UNCOUNT(L_add);
+	WMOPS_UNCOUNT(L_mult0);
+	return L_add(L_v3, L_mult0(v1, v2));
+}
+
+static inline int32_t L_msu0(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(L_msu0);
+	WMOPS_UNCOUNT(L_sub);
+	WMOPS_UNCOUNT(L_mult0);
+	return L_sub(L_v3, L_mult0(v1, v2));
+}
+
+static inline int16_t mac_r(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(mac_r);
+	WMOPS_UNCOUNT(round_fx);
+	WMOPS_UNCOUNT(L_mac);
+	return round_fx(L_mac(L_v3, v1, v2));
+}
+
+static inline int16_t msu_r(int32_t L_v3, int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(msu_r);
+	WMOPS_UNCOUNT(round_fx);
+	WMOPS_UNCOUNT(L_msu);
+	return round_fx(L_msu(L_v3, v1, v2));
+}
+#endif	/* BASIC_OP_INLINE */
+
+
 
 #ifdef	__cplusplus
 	extern "C" {
 #endif
 
+#ifndef	BASIC_OP_INLINE
 int16_t saturate(int32_t L_v1);				// Saturation
 int16_t add(int16_t v1, int16_t v2);		// Short add
 int16_t sub(int16_t v1, int16_t v2);		// Short sub
@@ -210,31 +530,40 @@ int16_t sub(int16_t v1, int16_t v2);		// Short sub
 int16_t shl(int16_t v1, int16_t v2);		// Short shift left
 int16_t shr(int16_t v1, int16_t v2);		// Short shift right
 // int16_t negate(int16_t v1);					// Short negate
+#endif
 int16_t norm_s(int16_t v1);					// Short norm
+#ifndef	BASIC_OP_INLINE
 int32_t L_add(int32_t L_v1, int32_t L_v2);	// Long add
 int32_t L_sub(int32_t L_v1, int32_t L_v2);	// Long sub
 // int32_t L_abs(int32_t L_v1);				// Long abs
 int32_t L_shl(int32_t L_v1, int16_t v2);	// Long shift left
 int32_t L_shr(int32_t L_v1, int16_t v2);	// Long shift right
 // int32_t L_negate(int32_t L_v1);				// Long negate
+#endif
 int16_t norm_l(int32_t L_v1);				// Long norm
+#ifndef	BASIC_OP_INLINE
 int32_t L_mult(int16_t v1, int16_t v2);		// Long mult
 int32_t L_mult0(int16_t v1, int16_t v2);	// 32-bit Multiply w/o shift 1
 int16_t mult(int16_t v1, int16_t v2);		// Short mult
 int16_t mult_r(int16_t v1, int16_t v2);		// Mult with round
 int32_t L_mac(int32_t L_v3, int16_t v1, int16_t v2);	// Mac
 int32_t L_mac0(int32_t L_v3, int16_t v1, int16_t v2);	// 32-bit Mac w/o shift 1
+#endif
 int32_t L_macNs(int32_t L_v3, int16_t v1, int16_t v2);	// Mac without sat
+#ifndef	BASIC_OP_INLINE
 int16_t mac_r(int32_t L_v3, int16_t v1, int16_t v2);	// Mac with rounding
 int32_t L_msu(int32_t L_v3, int16_t v1, int16_t v2);	// Msu
 int32_t L_msu0(int32_t L_v3, int16_t v1, int16_t v2);	// 32-bit Msu w/o shift 1
+#endif
 int32_t L_msuNs(int32_t L_v3, int16_t v1, int16_t v2);	// Msu without sat
+#ifndef	BASIC_OP_INLINE
 int16_t msu_r(int32_t L_v3, int16_t v1, int16_t v2);	// Msu with rounding
 // int16_t extract_h(int32_t L_v1);		// Extract high
 // int16_t extract_l(int32_t L_v1);		// Extract low
 int16_t round_fx(int32_t L_v1);			// Round
 // int32_t L_deposit_h(int16_t v1);		// 16 bits v1 -> 32 bits MSB
 // int32_t L_deposit_l(int16_t v1);		// 16 bits v1 -> 32 bits LSB
+#endif
 int32_t L_add_c(int32_t L_v1, int32_t L_v2);	// Long add with c
 int32_t L_sub_c(int32_t L_v1, int32_t L_v2);	// Long sub with c
 int16_t shr_r(int16_t v1, int16_t v2);			// Shift right with round
@@ -248,6 +577,27 @@ int16_t div_l(int32_t, int16_t);			// Weight FFS; currently assigned 32 */
 
 #ifdef	__cplusplus
 	}
+
+/**
+* @brief	Run the operators on ctx while the scope is alive.
+*
+*			BASIC_OP_CONTEXT ctx = { false, 0 };
+*			{
+*				BasicOpScope scope(ctx);
+*				...						// Overflow and Carry are ctx's.
+*			}
+*/
+class BasicOpScope {
+public:
+	BasicOpScope(BASIC_OP_CONTEXT& ctx) : ctx(ctx)	{ basic_op_swap_context(&ctx); }
+	~BasicOpScope()									{ basic_op_swap_context(&ctx); }
+
+	BasicOpScope(const BasicOpScope&) = delete;
+	BasicOpScope& operator=(const BasicOpScope&) = delete;
+
+private:
+	BASIC_OP_CONTEXT& ctx;
+};
 #endif
 
 #endif
@@ -0,0 +1,599 @@
+/*==============================================================================
+* @brief	Block (array) versions of the Basic Operators.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <string.h>
+
+#include "basic_op_block.h"
+
+/**
+*	GCC vector extensions are used on hosts with SSE2 or NEON. Other targets
+*	(e.g. Xtensa) and BASIC_OP_BLOCK_SCALAR builds use the scalar operators.
+*/
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON)) && !defined(BASIC_OP_BLOCK_SCALAR)
+	#define	BASIC_OP_BLOCK_SIMD
+#endif
+
+#ifdef	BASIC_OP_BLOCK_SIMD
+typedef int16_t		v8hi __attribute__((vector_size(16)));
+typedef uint16_t	v8hu __attribute__((vector_size(16)));
+typedef int32_t		v4si __attribute__((vector_size(16)));
+typedef uint32_t	v4su __attribute__((vector_size(16)));
+
+#define	VLOAD(v, p)		memcpy(&(v), (p), sizeof(v))		// Unaligned load/store.
+#define	VSTORE(p, v)	memcpy((p), &(v), sizeof(v))
+
+static inline v4si load4_s(const int16_t* p)
+{
+	v4si v = { p[0], p[1], p[2], p[3] };
+	return v;
+}
+
+static inline int any8(v8hi m)
+{
+	return 0 != (m[0] | m[1] | m[2] | m[3] | m[4] | m[5] | m[6] | m[7]);
+}
+
+static inline int any4(v4si m)
+{
+	return 0 != (m[0] | m[1] | m[2] | m[3]);
+}
+
+/**
+* @brief	Saturating add of 4 lanes. Overflow lanes are ORed into *ovf.
+*/
+static inline v4si L_add_v4(v4si a, v4si b, v4si* ovf)
+{
+	v4si r = (v4si)((v4su)a + (v4su)b);
+	v4si m = ((a ^ r) & (b ^ r)) < 0;
+	v4si sat = (a>>31) ^ INT32_MAX;
+
+	*ovf |= m;
+	return (r & ~m) | (sat & m);
+}
+#endif	/* BASIC_OP_BLOCK_SIMD */
+
+
+/**
+* @brief	out[i] = add(v1[i], v2[i])
+*/
+void add_blk(int16_t* out, const int16_t* v1, const int16_t* v2, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	v8hi ovf = { 0 };
+
+	for( ; 8 <= num; num -= 8) {
+		v8hi a, b;
+		VLOAD(a, v1);
+		VLOAD(b, v2);
+
+		v8hi r = (v8hi)((v8hu)a + (v8hu)b);
+		v8hi m = ((a ^ r) & (b ^ r)) < 0;
+		v8hi sat = (a>>15) ^ INT16_MAX;
+		r = (r & ~m) | (sat & m);
+		ovf |= m;
+
+		VSTORE(out, r);
+		out += 8;	v1 += 8;	v2 += 8;
+	}
+	if(any8(ovf)) {
+		BASIC_OP_OVERFLOW();
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*out++ = add(*v1++, *v2++);
+	}
+}
+
+/**
+* @brief	L_out[i] = L_add(L_v1[i], L_v2[i])
+*/
+void L_add_blk(int32_t* L_out, const int32_t* L_v1, const int32_t* L_v2, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	v4si ovf = { 0 };
+
+	for( ; 4 <= num; num -= 4) {
+		v4si a, b;
+		VLOAD(a, L_v1);
+		VLOAD(b, L_v2);
+
+		v4si r = L_add_v4(a, b, &ovf);
+
+		VSTORE(L_out, r);
+		L_out += 4;	L_v1 += 4;	L_v2 += 4;
+	}
+	if(any4(ovf)) {
+		BASIC_OP_OVERFLOW();
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*L_out++ = L_add(*L_v1++, *L_v2++);
+	}
+}
+
+/**
+* @brief	L_out[i] = L_mac(L_v3[i], v1[i], v2[i])
+*/
+void L_mac_blk(int32_t* L_out, const int32_t* L_v3, const int16_t* v1, const int16_t* v2, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	v4si ovf = { 0 };
+
+	for( ; 4 <= num; num -= 4) {
+		v4si acc;
+		VLOAD(acc, L_v3);
+
+		// L_mult(): 0x40000000 (= -32768*-32768) saturates to INT32_MAX.
+		v4si p = load4_s(v1)*load4_s(v2);
+		v4si m = (p == 0x40000000);
+		p = (v4si)(((v4su)p<<1) + (v4su)m);
+		ovf |= m;
+
+		v4si r = L_add_v4(acc, p, &ovf);
+
+		VSTORE(L_out, r);
+		L_out += 4;	L_v3 += 4;	v1 += 4;	v2 += 4;
+	}
+	if(any4(ovf)) {
+		BASIC_OP_OVERFLOW();
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*L_out++ = L_mac(*L_v3++, *v1++, *v2++);
+	}
+}
+
+/**
+* @brief	out[i] = round_fx(L_v1[i])
+*/
+void round_fx_blk(int16_t* out, const int32_t* L_v1, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	v4si ovf = { 0 };
+
+	for( ; 4 <= num; num -= 4) {
+		v4si a;
+		VLOAD(a, L_v1);
+
+		v4si m = (0x7FFF7FFF < a);
+		v4si r = (v4si)((v4su)a + 0x00008000u)>>16;
+		r = (r & ~m) | (INT16_MAX & m);
+		ovf |= m;
+
+		out[0] = r[0];	out[1] = r[1];	out[2] = r[2];	out[3] = r[3];
+		out += 4;	L_v1 += 4;
+	}
+	if(any4(ovf)) {
+		BASIC_OP_OVERFLOW();
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*out++ = round_fx(*L_v1++);
+	}
+}
+
+/**
+* @brief	out[i] = shl(v1[i], v2)
+*/
+void shl_blk(int16_t* out, const int16_t* v1, int16_t v2, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	if((0 < v2) && (v2 <= 15)) {
+		v8hi ovf = { 0 };
+
+		for( ; 8 <= num; num -= 8) {
+			v8hi a;
+			VLOAD(a, v1);
+
+			v8hi r = (v8hi)((v8hu)a<<v2);
+			v8hi m = ((r>>v2) != a);
+			v8hi sat = (a>>15) ^ INT16_MAX;
+			r = (r & ~m) | (sat & m);
+			ovf |= m;
+
+			VSTORE(out, r);
+			out += 8;	v1 += 8;
+		}
+		if(any8(ovf)) {
+			BASIC_OP_OVERFLOW();
+		}
+	} else if(v2 <= 0) {
+		int16_t s = (v2 < -15)? 15 : -v2;
+
+		for( ; 8 <= num; num -= 8) {
+			v8hi a;
+			VLOAD(a, v1);
+			a = a>>s;
+			VSTORE(out, a);
+			out += 8;	v1 += 8;
+		}
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*out++ = shl(*v1++, v2);
+	}
+}
+
+/**
+* @brief	L_out[i] = L_shl(L_v1[i], v2)
+*/
+void L_shl_blk(int32_t* L_out, const int32_t* L_v1, int16_t v2, int num)
+{
+#ifdef	BASIC_OP_BLOCK_SIMD
+	if((0 < v2) && (v2 <= 31)) {
+		v4si ovf = { 0 };
+
+		for( ; 4 <= num; num -= 4) {
+			v4si a;
+			VLOAD(a, L_v1);
+
+			v4si r = (v4si)((v4su)a<<v2);
+			v4si m = ((r>>v2) != a);
+			v4si sat = (a>>31) ^ INT32_MAX;
+			r = (r & ~m) | (sat & m);
+			ovf |= m;
+
+			VSTORE(L_out, r);
+			L_out += 4;	L_v1 += 4;
+		}
+		if(any4(ovf)) {
+			BASIC_OP_OVERFLOW();
+		}
+	} else if(v2 <= 0) {
+		int16_t s = (v2 < -31)? 31 : -v2;
+
+		for( ; 4 <= num; num -= 4) {
+			v4si a;
+			VLOAD(a, L_v1);
+			a = a>>s;
+			VSTORE(L_out, a);
+			L_out += 4;	L_v1 += 4;
+		}
+	}
+#endif
+	for( ; 0 < num; num--) {
+		*L_out++ = L_shl(*L_v1++, v2);
+	}
+}
+
+
+#define	L_DOT_CHUNK		8
+
+/**
+* @brief	Dot product with Q31 accumulation.
+*
+* @remark	The saturating L_mac chain is not associative, so the block is summed in
+*			chunks. A chunk is added in 64 bit at once when |L_v3| + sum(|2*v1*v2|)
+*			can not exceed INT32_MAX, i.e. when no partial sum of the chain can
+*			saturate. Otherwise the chunk falls back to the L_mac chain.
+*/
+int32_t L_dot(int32_t L_v3, const int16_t* v1, const int16_t* v2, int num)
+{
+	for( ; L_DOT_CHUNK <= num; num -= L_DOT_CHUNK) {
+		int64_t sum = 0;
+		int64_t mag = 0;
+
+		for(int i = 0; i < L_DOT_CHUNK; i++) {		// Vectorizable.
+			int32_t p = (int32_t)v1[i]*(int32_t)v2[i];
+			sum += p;
+			mag += (p < 0)? -(int64_t)p : p;
+		}
+
+		int64_t acc = L_v3;
+		if(((acc < 0)? -acc : acc) + 2*mag <= INT32_MAX) {
+			L_v3 = (int32_t)(acc + 2*sum);
+		} else {
+			for(int i = 0; i < L_DOT_CHUNK; i++) {
+				L_v3 = L_mac(L_v3, v1[i], v2[i]);
+			}
+		}
+		v1 += L_DOT_CHUNK;
+		v2 += L_DOT_CHUNK;
+	}
+	for( ; 0 < num; num--) {
+		L_v3 = L_mac(L_v3, *v1++, *v2++);
+	}
+	return L_v3;
+}
+
+
+/*-------------------------------------------------------------------------------
+*	Module Debug 
+-------------------------------------------------------------------------------*/
+#ifdef MODULE_DEBUG
+/*
+*	Host test of the block operators.
+*
+*	Every block operator is compared with the loop of the scalar operator over
+*	randomized blocks: lengths 0..MAX_LENGTH (the vector body and the tail),
+*	quiet and saturating inputs mixed with edge values, in-place operation and
+*	both initial Overflow states. The outputs and the Overflow flag must match.
+*	Then the throughput of the block and of the scalar loop is measured.
+*	Build with -DBASIC_OP_BLOCK_SCALAR to test the scalar path.
+*
+*	e.g.	gcc -O2 -c basic_op.c wmops.c
+*			gcc -O2 -DMODULE_DEBUG basic_op_block.c basic_op.o wmops.o -o basic_op_block && ./basic_op_block
+*/
+#include <stdio.h>
+#include <time.h>
+
+#define	NUMOF_ROUNDS	200000
+#define	MAX_LENGTH		67				// Covers 8 vectors of 8 and any tail.
+#define	BENCH_LENGTH	256
+#define	NUMOF_BENCH		20000
+#define	MAX_REPORTS		4				// Mismatches printed per operator.
+
+static int16_t s1[BENCH_LENGTH], s2[BENCH_LENGTH];
+static int32_t l1[BENCH_LENGTH], l2[BENCH_LENGTH];
+static int16_t so[BENCH_LENGTH], se[BENCH_LENGTH];
+static int32_t lo[BENCH_LENGTH], le[BENCH_LENGTH];
+
+static uint64_t rnd_state = 0x3243F6A8885A308DULL;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state<<13;
+	rnd_state ^= rnd_state>>7;
+	rnd_state ^= rnd_state<<17;
+	return (uint32_t)(rnd_state>>16);
+}
+
+/**
+* @param[in] quiet	true: Small values which never saturate.
+*/
+static int16_t gen_s(bool quiet)
+{
+	static const int16_t edge_s[] = {
+		0, 1, -1, INT16_MAX, INT16_MIN, INT16_MAX - 1, INT16_MIN + 1, 0x4000, -0x4000, 0x3fff, -0x4001,
+	};
+	uint32_t r = rnd();
+
+	if(quiet) {
+		return (int16_t)((r>>16) & 0xff) - 128;
+	}
+	switch(r & 7) {
+	case 0:
+	case 1:		return edge_s[(r>>3) % (sizeof(edge_s)/sizeof(edge_s[0]))];
+	default:	return (int16_t)(r>>16);
+	}
+}
+
+static int32_t gen_l(bool quiet)
+{
+	static const int32_t edge_l[] = {
+		0, 1, -1, INT32_MAX, INT32_MIN, INT32_MAX - 1, INT32_MIN + 1, 0x40000000, -0x40000000,
+		0x3fffffff, -0x40000001, 0x7fff8000, 0x7fff7fff, 0x7fff7ffe, 0x8000, 0x7fff, -0x8000,
+	};
+	uint32_t r = rnd();
+
+	if(quiet) {
+		return (int32_t)((r>>8) & 0xfffff) - 0x80000;
+	}
+	switch(r & 7) {
+	case 0:		return edge_l[(r>>3) % (sizeof(edge_l)/sizeof(edge_l[0]))];
+	case 1:		return INT32_MAX - (int32_t)(rnd() & 0xffff);
+	case 2:		return INT32_MIN + (int32_t)(rnd() & 0xffff);
+	default:	return (int32_t)rnd();
+	}
+}
+
+static int16_t gen_shift(int max)
+{
+	static const int16_t edge_shift[] = {
+		INT16_MIN, -33, -32, -31, -17, -16, -15, -1, 0, 1, 14, 15, 16, 30, 31,
+	};
+	uint32_t r = rnd();
+	int16_t s = (0 == (r & 3))? edge_shift[(r>>2) % (sizeof(edge_shift)/sizeof(edge_shift[0]))] : (int16_t)((r>>8) % 72) - 40;
+
+	return (max < s)? max : s;			// (1<<32) of shl() is undefined.
+}
+
+/*-------------------------------------------------------------------------------
+*	Test runner
+-------------------------------------------------------------------------------*/
+static int total_fails = 0;
+static volatile int32_t bench_sink;
+
+static double elapsed_ns(const struct timespec* t0, const struct timespec* t1)
+{
+	return (t1->tv_sec - t0->tv_sec)*1e9 + (t1->tv_nsec - t0->tv_nsec);
+}
+
+/**
+* @brief	Compare the block output (out, ovf) with the scalar one (ref, ref_ovf).
+*/
+static int check(const char* name, const void* out, const void* ref, size_t size, int num, bool ovf, bool ref_ovf, int fails)
+{
+	if((0 != memcmp(out, ref, size*num)) || (ovf != ref_ovf)) {
+		if(fails < MAX_REPORTS) {
+			int i = 0;
+			while((i < num) && (0 == memcmp((const char*)out + size*i, (const char*)ref + size*i, size))) {
+				i++;
+			}
+			if(i < num) {
+				printf("%s(num=%d): first mismatch at %d, ovf=%d, expected ovf=%d\n", name, num, i, ovf, ref_ovf);
+			} else {
+				printf("%s(num=%d): outputs match, ovf=%d, expected ovf=%d\n", name, num, ovf, ref_ovf);
+			}
+		}
+		fails++;
+	}
+	return fails;
+}
+
+/**
+* @param[in] name		Operator name.
+* @param[in] size		Size of the output element.
+* @param[in] count		The number of output elements to compare.
+* @param[in] gen		Fill the inputs of 0..num-1 with quiet or full scale values.
+* @param[in] inplace	Copy the input to out, used when the block runs in place.
+* @param[in] blk		Block call writing out.
+* @param[in] ref		Scalar loop writing ref.
+*/
+#define	TEST_BLK(name, size, count, gen, inplace, blk, ref)							\
+	do {																				\
+		int fails = 0;																	\
+		long tests = 0;																	\
+		for(int round = 0; round < NUMOF_ROUNDS; round++, tests++) {					\
+			int num = rnd() % (MAX_LENGTH + 1);											\
+			bool quiet = (0 == (rnd() & 3));											\
+			bool in_place = (0 == (rnd() & 3));										\
+			bool ovf_init = (0 == (rnd() & 7));										\
+			int16_t shift = gen_shift(31);												\
+			(void)shift;	(void)in_place;												\
+			for(int i = 0; i < num; i++) {												\
+				gen;																	\
+			}																			\
+			if(in_place) {																\
+				inplace;																\
+			}																			\
+			Overflow = ovf_init;														\
+			blk;																		\
+			bool ovf = Overflow;														\
+			Overflow = ovf_init;														\
+			for(int i = 0; i < num; i++) {												\
+				ref;																	\
+			}																			\
+			fails = check(name, out, ref_out, size, count, ovf, Overflow, fails);	\
+		}																				\
+																						\
+		struct timespec t0, t1, t2;														\
+		int num = BENCH_LENGTH;															\
+		bool quiet = true;																\
+		bool in_place = false;															\
+		int16_t shift = 3;																\
+		(void)shift;	(void)in_place;													\
+		for(int i = 0; i < num; i++) {													\
+			gen;																		\
+		}																				\
+		clock_gettime(CLOCK_MONOTONIC, &t0);											\
+		for(int rep = 0; rep < NUMOF_BENCH; rep++) {									\
+			blk;																		\
+			bench_sink ^= out[rep & (BENCH_LENGTH - 1)];								\
+		}																				\
+		clock_gettime(CLOCK_MONOTONIC, &t1);											\
+		for(int rep = 0; rep < NUMOF_BENCH; rep++) {									\
+			for(int i = 0; i < num; i++) {												\
+				ref;																	\
+			}																			\
+			bench_sink ^= ref_out[rep & (BENCH_LENGTH - 1)];							\
+		}																				\
+		clock_gettime(CLOCK_MONOTONIC, &t2);											\
+																						\
+		printf("%-12s %8ld blocks %6d fails %8.3f ns/sample (scalar %8.3f ns/sample)\n", name, tests, fails,	\
+			elapsed_ns(&t0, &t1)/((double)NUMOF_BENCH*BENCH_LENGTH),					\
+			elapsed_ns(&t1, &t2)/((double)NUMOF_BENCH*BENCH_LENGTH));					\
+		total_fails += fails;															\
+	} while(0)
+
+
+int main(void)
+{
+	printf("%s path.\n",
+#ifdef	BASIC_OP_BLOCK_SIMD
+		"SIMD"
+#else
+		"Scalar"
+#endif
+	);
+
+	{
+		int16_t* out = so;
+		int16_t* ref_out = se;
+		TEST_BLK("add_blk", sizeof(int16_t), num,
+			(s1[i] = gen_s(quiet), s2[i] = gen_s(quiet)),
+			memcpy(so, s1, sizeof(s1)),
+			add_blk(so, in_place? so : s1, s2, num),
+			se[i] = add(s1[i], s2[i]));
+	}
+	{
+		int32_t* out = lo;
+		int32_t* ref_out = le;
+		TEST_BLK("L_add_blk", sizeof(int32_t), num,
+			(l1[i] = gen_l(quiet), l2[i] = gen_l(quiet)),
+			memcpy(lo, l1, sizeof(l1)),
+			L_add_blk(lo, in_place? lo : l1, l2, num),
+			le[i] = L_add(l1[i], l2[i]));
+	}
+	{
+		int32_t* out = lo;
+		int32_t* ref_out = le;
+		TEST_BLK("L_mac_blk", sizeof(int32_t), num,
+			(l1[i] = gen_l(quiet), s1[i] = gen_s(quiet), s2[i] = gen_s(quiet)),
+			memcpy(lo, l1, sizeof(l1)),
+			L_mac_blk(lo, in_place? lo : l1, s1, s2, num),
+			le[i] = L_mac(l1[i], s1[i], s2[i]));
+	}
+	{
+		int16_t* out = so;
+		int16_t* ref_out = se;
+		TEST_BLK("round_fx_blk", sizeof(int16_t), num,
+			l1[i] = gen_l(quiet),
+			(void)0,
+			round_fx_blk(so, l1, num),
+			se[i] = round_fx(l1[i]));
+	}
+	{
+		int16_t* out = so;
+		int16_t* ref_out = se;
+		TEST_BLK("shl_blk", sizeof(int16_t), num,
+			s1[i] = gen_s(quiet),
+			memcpy(so, s1, sizeof(s1)),
+			shl_blk(so, in_place? so : s1, shift, num),
+			se[i] = shl(s1[i], shift));
+	}
+	{
+		int32_t* out = lo;
+		int32_t* ref_out = le;
+		TEST_BLK("L_shl_blk", sizeof(int32_t), num,
+			l1[i] = gen_l(quiet),
+			memcpy(lo, l1, sizeof(l1)),
+			L_shl_blk(lo, in_place? lo : l1, shift, num),
+			le[i] = L_shl(l1[i], shift));
+	}
+	{
+		// The accumulator is the first element of the output.
+		int32_t* out = lo;
+		int32_t* ref_out = le;
+		TEST_BLK("L_dot", sizeof(int32_t), 1,
+			(s1[i] = gen_s(quiet), s2[i] = gen_s(quiet), l1[0] = gen_l(quiet)),
+			(void)0,
+			(le[0] = l1[0], lo[0] = L_dot(l1[0], s1, s2, num)),
+			le[0] = L_mac(le[0], s1[i], s2[i]));
+	}
+
+	printf("%s: %d fails\n", (0 == total_fails)? "PASS" : "FAIL", total_fails);
+
+	return (0 == total_fails)? 0 : 1;
+}
+#endif	/* MODULE_DEBUG */
+/*==============================================================================
+*	End
+*===============================================================================*/
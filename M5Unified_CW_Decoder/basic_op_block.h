@@ -0,0 +1,81 @@
+/*==============================================================================
+* @brief	Block (array) versions of the Basic Operators.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef _BASIC_OP_BLOCK_H
+#define _BASIC_OP_BLOCK_H
+
+#include "basic_op.h"
+
+#ifdef	__cplusplus
+	extern "C" {
+#endif
+
+/**
+* @brief	Element-wise operators over num samples. Every output is bit-exact with
+*			the scalar operator of the same name, and Overflow is set when any of
+*			the elements overflows.
+*
+*			add_blk:		out[i] = add(v1[i], v2[i])
+*			L_add_blk:		L_out[i] = L_add(L_v1[i], L_v2[i])
+*			L_mac_blk:		L_out[i] = L_mac(L_v3[i], v1[i], v2[i])
+*			round_fx_blk:	out[i] = round_fx(L_v1[i])
+*			shl_blk:		out[i] = shl(v1[i], v2)
+*			L_shl_blk:		L_out[i] = L_shl(L_v1[i], v2)
+*
+* @remark	In-place operation (out == input) is allowed.
+*/
+void add_blk(int16_t* out, const int16_t* v1, const int16_t* v2, int num);
+void L_add_blk(int32_t* L_out, const int32_t* L_v1, const int32_t* L_v2, int num);
+void L_mac_blk(int32_t* L_out, const int32_t* L_v3, const int16_t* v1, const int16_t* v2, int num);
+void round_fx_blk(int16_t* out, const int32_t* L_v1, int num);
+void shl_blk(int16_t* out, const int16_t* v1, int16_t v2, int num);
+void L_shl_blk(int32_t* L_out, const int32_t* L_v1, int16_t v2, int num);
+
+/**
+* @brief	Dot product with Q31 accumulation. Same as the L_mac chain:
+*				for(i = 0; i < num; i++) L_v3 = L_mac(L_v3, v1[i], v2[i]);
+*
+* @param[in] L_v3	Initial value of the accumulator.
+* @param[in] v1		v1[num].
+* @param[in] v2		v2[num].
+* @param[in] num	The number of samples.
+*
+* @return	32 bit accumulator.
+*/
+int32_t L_dot(int32_t L_v3, const int16_t* v1, const int16_t* v2, int num);
+
+#ifdef	__cplusplus
+	}
+#endif
+
+#endif
+/*==============================================================================
+*	End
+==============================================================================*/
@@ -33,9 +33,8 @@
 #include "bilinear.h"
 
 //------------------------------------------------------------------------------
-static BILINEAR_TYPE*  a2c(const BILINEAR_TYPE* a, BILINEAR_TYPE* c, int N, BILINEAR_TYPE T) 
+static BILINEAR_TYPE*  a2c(const BILINEAR_TYPE* a, BILINEAR_TYPE* c, int N, BILINEAR_TYPE T, BILINEAR_TYPE* buf) 
 {
-	BILINEAR_TYPE* buf = malloc(N*sizeof(BILINEAR_TYPE));
 	int i, j, k, l, m;
 
 	for(i = 0; i < N; i++)     c[i] = 0.0;
@@ -59,7 +58,6 @@ static BILINEAR_TYPE*  a2c(const BILINEAR_TYPE* a, BILINEAR_TYPE* c, int N, BILI
 		for(i = 0; i < N; i++)     c[i] += buf[i];     
 	}
 
-	free(buf);
 	return c;
 }
 
@@ -85,6 +83,27 @@ static void normalize(BILINEAR_TYPE* num, BILINEAR_TYPE* den, int N)
 * @param[in] T			Sampling Period (sec.). = 1/Fs. Fs is Sampling Frequency (Hz)
 */
 void bilinear(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, BILINEAR_TYPE T)
+{
+	BILINEAR_TYPE* work = malloc(BILINEAR_WORK_SIZE(N)*sizeof(BILINEAR_TYPE));
+
+	bilinear_r(numd, dend, numa, dena, N, T, work);
+
+	free(work);
+}
+
+
+/**
+* @brief bilinear() with the scratch space of the caller. No heap.
+*
+* @param[out] numd		Digital-domain numerator coefficients. numd[N].	
+* @param[out] dend		Digital-domain denominator coefficients. dend[N].	
+* @param[in] numa		Analog-domain numerator coefficients. numa[N].
+* @param[in] dena		Analog-domain denominator coefficients. dena[N].
+* @param[in] N			Number of coefficients.
+* @param[in] T			Sampling Period (sec.). = 1/Fs. Fs is Sampling Frequency (Hz)
+* @param[in] work		Scratch space. work[BILINEAR_WORK_SIZE(N)].
+*/
+void bilinear_r(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, BILINEAR_TYPE T, BILINEAR_TYPE* work)
 {
 	int n;
 
@@ -94,12 +113,36 @@ void bilinear(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* num
 	}
 	n++;
 
-	a2c(numa, numd, n, T); 
-	a2c(dena, dend, n, T); 
+	a2c(numa, numd, n, T, work); 
+	a2c(dena, dend, n, T, work); 
 	normalize(numd, dend, n);
 }
 
 
+/**
+* @brief Bilinear transformation of num filters of the same number of coefficients.
+*
+* @param[out] numd		Digital-domain numerator coefficients. numd[num][N].	
+* @param[out] dend		Digital-domain denominator coefficients. dend[num][N].	
+* @param[in] numa		Analog-domain numerator coefficients. numa[num][N].
+* @param[in] dena		Analog-domain denominator coefficients. dena[num][N].
+* @param[in] N			Number of coefficients.
+* @param[in] num		Number of filters.
+* @param[in] T			Sampling Period (sec.). = 1/Fs. Fs is Sampling Frequency (Hz)
+* @param[in] work		Scratch space. work[BILINEAR_WORK_SIZE(N)], shared by all filters.
+*/
+void bilinear_batch(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, int num, BILINEAR_TYPE T, BILINEAR_TYPE* work)
+{
+	int i;
+
+	for(i = 0; i < num; i++) {
+		bilinear_r(numd, dend, numa, dena, N, T, work);
+		numd += N;	dend += N;
+		numa += N;	dena += N;
+	}
+}
+
+
 /**
 * @brief	Prewarping for bilinear tranformation method. 
 *
@@ -33,6 +33,8 @@
 
 #define	BILINEAR_TYPE	float		// or double
 
+#define	BILINEAR_WORK_SIZE(N)	(N)	// Elements of the scratch space of bilinear_r() and bilinear_batch().
+
 #ifdef	__cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -49,6 +51,27 @@ extern "C" {
 */
 extern void bilinear(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, BILINEAR_TYPE T);
 
+/**
+* @brief bilinear() with the scratch space of the caller. No heap.
+*
+* @param[in] work		Scratch space. work[BILINEAR_WORK_SIZE(N)].
+*/
+extern void bilinear_r(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, BILINEAR_TYPE T, BILINEAR_TYPE* work);
+
+/**
+* @brief Bilinear transformation of num filters at once. No heap.
+*
+* @param[out] numd		numd[num][N].
+* @param[out] dend		dend[num][N].
+* @param[in] numa		numa[num][N].
+* @param[in] dena		dena[num][N].
+* @param[in] N			Number of coefficients of each filter.
+* @param[in] num		Number of filters.
+* @param[in] T			Sampling Period (sec.).
+* @param[in] work		Scratch space. work[BILINEAR_WORK_SIZE(N)].
+*/
+extern void bilinear_batch(BILINEAR_TYPE* numd, BILINEAR_TYPE* dend, const BILINEAR_TYPE* numa, const BILINEAR_TYPE* dena, int N, int num, BILINEAR_TYPE T, BILINEAR_TYPE* work);
+
 
 /**
 * @brief	Prewarping for bilinear tranformation method. 
@@ -64,6 +87,70 @@ extern BILINEAR_TYPE bilinear_prewarp(BILINEAR_TYPE wa, BILINEAR_TYPE T);
 }
 #endif /* __cplusplus */
 
+
+#ifdef	__cplusplus
+#include "cxmath.hpp"
+
+/**
+* @brief	bilinear() at compile time. The same steps in BILINEAR_TYPE, so the
+*			coefficients agree with bilinear() at run time. No heap.
+*
+* @tparam N		Number of coefficients.
+*/
+template <int N>
+struct CxBilinear {
+	BILINEAR_TYPE numd[N];		// Digital-domain numerator coefficients.
+	BILINEAR_TYPE dend[N];		// Digital-domain denominator coefficients.
+
+	constexpr CxBilinear(const BILINEAR_TYPE (&numa)[N], const BILINEAR_TYPE (&dena)[N], BILINEAR_TYPE T) : numd{}, dend{}
+	{
+		int n = N - 1;
+		while((0.0 == numa[n]) && (0.0 == dena[n]) && (0 < n)) {
+			n--;
+		}
+		n++;
+
+		a2c(numa, numd, n, T);
+		a2c(dena, dend, n, T);
+
+		for(int i = n - 1; 0 <= i; i--) {
+			numd[i] /= dend[0];
+			dend[i] /= dend[0];
+		}
+	}
+
+	static constexpr void a2c(const BILINEAR_TYPE* a, BILINEAR_TYPE* c, int n, BILINEAR_TYPE T)
+	{
+		for(int k = 0; k < n; k++) {
+			BILINEAR_TYPE buf[N] = {};
+			buf[0] = a[k];
+
+			for(int l = 1; l <= k; l++) {
+				for(int m = n - 1; m >= 1; m--) {
+					buf[m] += -2.f* buf[m-1];
+					buf[m-1] *= 2.f;
+				}
+			}
+			for(int l = k+1; l < n; l++) {
+				for(int m = n - 1; m >= 1; m--) {
+					buf[m] += (T* buf[m-1]);
+					buf[m-1] *= T;
+				}
+			}
+			for(int i = 0; i < n; i++)	c[i] += buf[i];
+		}
+	}
+};
+
+/**
+* @brief	bilinear_prewarp() at compile time.
+*/
+constexpr BILINEAR_TYPE cx_bilinear_prewarp(BILINEAR_TYPE wa, BILINEAR_TYPE T)
+{
+	return 	(BILINEAR_TYPE)(2.0*cx_tan(wa*T/2.0)/T);
+}
+#endif /* __cplusplus */
+
 #endif	/* _BILINEAR_H */
 /*==============================================================================
  *	End 
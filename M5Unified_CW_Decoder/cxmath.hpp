@@ -0,0 +1,84 @@
+/*==============================================================================
+* @brief	constexpr math functions for coefficients computed at compile time.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_CXMATH_HPP
+#define	_CXMATH_HPP
+
+constexpr double CX_PI = 3.14159265358979323846;
+
+/**
+* @brief	Round to the nearest integer.
+*/
+constexpr double cx_round(double x)
+{
+	return (x < 0)? -static_cast<double>(static_cast<long long>(0.5 - x))
+				  :  static_cast<double>(static_cast<long long>(0.5 + x));
+}
+
+/**
+* @brief	Cosine. The Taylor series after reducing x to [-pi, pi].
+*
+* @remark	The error is within a few ulp of double, so the Q14/Q15 values
+*			rounded from it agree with cos() of libm.
+*/
+constexpr double cx_cos(double x)
+{
+	x -= 2*CX_PI*cx_round(x/(2*CX_PI));
+
+	double x2 = x*x;
+	double term = 1;
+	double sum = 1;
+	for(int n = 1; n <= 16; n++) {
+		term *= -x2/((2*n - 1)*(2*n));
+		sum += term;
+	}
+	return sum;
+}
+
+/**
+* @brief	Sine.
+*/
+constexpr double cx_sin(double x)
+{
+	return cx_cos(x - CX_PI/2);
+}
+
+/**
+* @brief	Tangent.
+*/
+constexpr double cx_tan(double x)
+{
+	return cx_sin(x)/cx_cos(x);
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,154 @@
+/*==============================================================================
+* @brief	Polyphase FIR decimator.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <cmath>
+#include <string.h>
+#include "basic_op.h"
+#include "f2q.h"
+
+#include "decimator.hpp"
+
+
+Decimator::Decimator(int factor, int taps)
+	: factor((factor < 1)? 1 : factor), taps(taps), pos(0)
+{
+	int N = this->factor*taps;
+	coef = new int16_t[N];
+	delay = new int16_t[2*N];
+	memset(delay, 0, 2*N*sizeof(delay[0]));
+	phase = this->factor - 1;
+
+	// Windowed sinc. Cutoff = DECIMATOR_CUTOFF*fs/factor.
+	float* h = new float[N];
+	float sum = 0;
+	for(int n = 0; n < N; n++) {
+		float t = n - (N - 1)/2.0f;
+		float x = 2*M_PI*DECIMATOR_CUTOFF*t/this->factor;
+		float w = 0.42f - 0.5f*cos(2*M_PI*(n + 1)/(N + 1)) + 0.08f*cos(4*M_PI*(n + 1)/(N + 1));
+		h[n] = ((0 == t)? 1.0f : sin(x)/x)*w;
+		sum += h[n];
+	}
+	for(int n = 0; n < N; n++) {
+		int p = n%this->factor;
+		int l = n/this->factor;
+		coef[p*taps + l] = F2Q15(h[n]/sum);
+	}
+	delete[] h;
+}
+
+int Decimator::decimate(int16_t* out, const int16_t* in, int num)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_DECIMATOR);
+
+	int16_t* top = out;
+
+	for( ; 0 < num; num--) {
+		if(factor - 1 == phase) {		// New output. Advance the delay lines.
+			pos = (0 == pos)? taps - 1 : pos - 1;
+		}
+
+		int16_t* d = delay + 2*taps*phase + pos;
+		d[0] = d[taps] = *in++;
+
+		if(0 < phase) {
+			phase--;
+			continue;
+		}
+		phase = factor - 1;
+
+		int32_t acc = 0;
+		const int16_t* c = coef;
+		for(int p = 0; p < factor; p++) {
+			const int16_t* x = delay + 2*taps*p + pos;		// e_p[0] is the newest.
+			for(int l = 0; l < taps; l++) {
+				acc = L_mac(acc, *c++, *x++);
+			}
+		}
+		*out++ = round_fx(acc);
+	}
+
+	return out - top;
+}
+
+//----------------------------------------------------------------------------------
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+/**
+* @brief	Gain of a -6dBFS sine at the output rate after the transient.
+*/
+static float gain(Decimator& decimator, float f, float fs, int16_t* x, int num)
+{
+	int peak = 0;
+	for(int block = 0; block < 4; block++) {
+		for(int n = 0; n < num; n++) {
+			x[n] = F2Q15(0.5*sin(2*M_PI*f*(block*num + n)/fs));
+		}
+		int m = decimator.decimate(x, x, num);
+		for(int n = 0; (0 < block) && (n < m); n++) {
+			peak = (peak < abs(x[n]))? abs(x[n]) : peak;
+		}
+	}
+	return 20*log10((peak + 0.5)/16384.0);
+}
+
+int main(int argc, char* argv[])
+{
+	const float fs = 8000;
+	int factor = (1 < argc)? atoi(argv[1]) : 4;
+	int taps = (2 < argc)? atoi(argv[2]) : DECIMATOR_TAPS_PER_PHASE;
+	const int num = 200*factor;
+
+	Decimator decimator(factor, taps);
+	int16_t* x = new int16_t[num];
+
+	printf("factor %d, %d taps: %.0f Hz -> %.0f Hz\n", factor, factor*taps, fs, fs/factor);
+	for(float f = 100; f < fs/2; f *= 1.25f) {
+		printf("%7.1f Hz %7.2f dB\n", f, gain(decimator, f, fs, x, num));
+	}
+
+	// Worst alias from the output Nyquist.
+	float worst = -200;
+	for(float f = fs/factor/2; (1 < factor) && (f < fs/2); f += 10) {
+		worst = std::max(worst, gain(decimator, f, fs, x, num));
+	}
+	printf("Stopband from %.0f Hz: %.2f dB max.\n", fs/factor/2, worst);
+	delete[] x;
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
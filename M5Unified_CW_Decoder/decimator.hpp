@@ -0,0 +1,99 @@
+/*==============================================================================
+* @brief	Polyphase FIR decimator.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_DECIMATOR_HPP
+#define	_DECIMATOR_HPP
+
+#include <stdint.h>
+
+//******** Configurations ********************************************
+#define	DECIMATOR_TAPS_PER_PHASE	24		// Taps of the lowpass = factor*DECIMATOR_TAPS_PER_PHASE.
+#define	DECIMATOR_CUTOFF			0.4		// Cutoff of the lowpass / output rate. The stopband starts at about output rate/2.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Decimates the samples by the factor with a fixed-point FIR lowpass.
+*
+* @remark	The lowpass h[] of factor*taps is split into the phases
+*			e_p[l] = h[l*factor + p] (p = 0...factor - 1), and the input is
+*			dealt to the delay lines of the phases by a commutator:
+*				y[m] = sum_p sum_l e_p[l]*x[(m - l)*factor - p]
+*			So only the outputs at the low rate are computed, i.e. taps MACs
+*			per input. The lowpass is the windowed sinc with the Blackman window
+*			and the DC gain of 1. The cutoff is DECIMATOR_CUTOFF of the output
+*			rate, so the aliases into the band below the output rate/2 are
+*			attenuated by about 60 dB with 24 taps per phase.
+*/
+class Decimator {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] factor		Decimation factor. 1 passes the samples through.
+	* @param[in] taps		Taps per phase.
+	*/
+	Decimator(int factor = 4, int taps = DECIMATOR_TAPS_PER_PHASE);
+
+	~Decimator() {
+		delete[] coef;
+		delete[] delay;
+	}
+
+	Decimator(const Decimator&) = delete;
+	Decimator& operator=(const Decimator&) = delete;
+
+	/**
+	* @brief	Decimation.
+	*
+	* @param[out] out		Q15 outputs. out[num/factor + 1].
+	* @param[in] in			Q15 inputs. in[num].
+	* @param[in] num		The number of inputs.
+	*
+	* @return	The number of outputs. num/factor when num is a multiple of factor.
+	*
+	* @remark	In-place operation (out == in) is allowed.
+	*/
+	int decimate(int16_t* out, const int16_t* in, int num);
+
+	int getFactor(void) const	{ return factor; }
+
+private:
+	int factor;
+	int taps;			// Taps per phase.
+	int16_t* coef;		// coef[factor][taps]. Q15. Phase-major.
+	int16_t* delay;		// delay[factor][2*taps]. Written twice, so the taps are contiguous.
+	int pos;			// Newest sample of the delay lines. 0...taps - 1.
+	int phase;			// Phase of the next input. factor - 1 ... 0.
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,302 @@
+/*==============================================================================
+* @brief	Envelope detector by the NCO mixer and the CIC decimator.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <cmath>
+#include <string.h>
+#include "basic_op.h"
+
+#include "envelope.hpp"
+
+
+/**
+*	sin(2*pi*t/256) in Q15. t = 0...255.
+*/
+static const int16_t nco_table[256] = {
+	     0,    804,   1608,   2411,   3212,   4011,   4808,   5602,
+	  6393,   7180,   7962,   8740,   9512,  10279,  11039,  11793,
+	 12540,  13279,  14010,  14733,  15447,  16151,  16846,  17531,
+	 18205,  18868,  19520,  20160,  20788,  21403,  22006,  22595,
+	 23170,  23732,  24279,  24812,  25330,  25833,  26320,  26791,
+	 27246,  27684,  28106,  28511,  28899,  29269,  29622,  29957,
+	 30274,  30572,  30853,  31114,  31357,  31581,  31786,  31972,
+	 32138,  32286,  32413,  32522,  32610,  32679,  32729,  32758,
+	 32767,  32758,  32729,  32679,  32610,  32522,  32413,  32286,
+	 32138,  31972,  31786,  31581,  31357,  31114,  30853,  30572,
+	 30274,  29957,  29622,  29269,  28899,  28511,  28106,  27684,
+	 27246,  26791,  26320,  25833,  25330,  24812,  24279,  23732,
+	 23170,  22595,  22006,  21403,  20788,  20160,  19520,  18868,
+	 18205,  17531,  16846,  16151,  15447,  14733,  14010,  13279,
+	 12540,  11793,  11039,  10279,   9512,   8740,   7962,   7180,
+	  6393,   5602,   4808,   4011,   3212,   2411,   1608,    804,
+	     0,   -804,  -1608,  -2411,  -3212,  -4011,  -4808,  -5602,
+	 -6393,  -7180,  -7962,  -8740,  -9512, -10279, -11039, -11793,
+	-12540, -13279, -14010, -14733, -15447, -16151, -16846, -17531,
+	-18205, -18868, -19520, -20160, -20788, -21403, -22006, -22595,
+	-23170, -23732, -24279, -24812, -25330, -25833, -26320, -26791,
+	-27246, -27684, -28106, -28511, -28899, -29269, -29622, -29957,
+	-30274, -30572, -30853, -31114, -31357, -31581, -31786, -31972,
+	-32138, -32286, -32413, -32522, -32610, -32679, -32729, -32758,
+	-32768, -32758, -32729, -32679, -32610, -32522, -32413, -32286,
+	-32138, -31972, -31786, -31581, -31357, -31114, -30853, -30572,
+	-30274, -29957, -29622, -29269, -28899, -28511, -28106, -27684,
+	-27246, -26791, -26320, -25833, -25330, -24812, -24279, -23732,
+	-23170, -22595, -22006, -21403, -20788, -20160, -19520, -18868,
+	-18205, -17531, -16846, -16151, -15447, -14733, -14010, -13279,
+	-12540, -11793, -11039, -10279,  -9512,  -8740,  -7962,  -7180,
+	 -6393,  -5602,  -4808,  -4011,  -3212,  -2411,  -1608,   -804,
+};
+
+#define	NCO_COS		64		// cos(x) = sin(x + pi/2)
+
+/**
+* @brief	Wrap-around add/sub of the CIC.
+*/
+static inline int32_t wrap_add(int32_t a, int32_t b)
+{
+	WMOPS_COUNT(L_add);
+	return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+static inline int32_t wrap_sub(int32_t a, int32_t b)
+{
+	WMOPS_COUNT(L_sub);
+	return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+
+EnvelopeDetector::EnvelopeDetector(float freq, float sampling_freq, int N, int R)
+	: N(N), log2r(0), count(0), last(0), phase(0), callback(nullptr), user(nullptr)
+{
+	while((log2r < ENVELOPE_MAX_LOG2R) && ((2 << log2r) <= R)) {
+		log2r++;
+	}
+	memset(integ, 0, sizeof(integ));
+	memset(comb, 0, sizeof(comb));
+
+	setFreq(freq, sampling_freq);
+}
+
+void EnvelopeDetector::setFreq(float freq, float sampling_freq)
+{
+	step = (uint32_t)(int64_t)(freq/sampling_freq*4294967296.0 + 0.5);
+}
+
+/**
+* @brief	Combs of the I/Q at the output rate, and the magnitude.
+*
+* @return	Magnitude. Q15 format.
+*/
+int16_t EnvelopeDetector::decimate(void)
+{
+	int16_t iq[2];
+
+	for(int c = 0; c < 2; c++) {
+		int32_t x = integ[c][ENVELOPE_CIC_ORDER - 1];
+		for(int k = 0; k < ENVELOPE_CIC_ORDER; k++) {
+			int32_t d = comb[c][k];
+			comb[c][k] = x;
+			x = wrap_sub(x, d);
+		}
+		// Gain of the CIC is R^ORDER. Q15*R^ORDER -> Q31 -> Q15.
+		iq[c] = round_fx(L_shl(x, 16 - ENVELOPE_CIC_ORDER*log2r));
+	}
+
+	return Goertzel::magnitude(L_mac(L_mult(iq[0], iq[0]), iq[1], iq[1]));
+}
+
+/**
+* @brief	Mixer and integrators at the input rate.
+*
+* @param[out] env		Magnitudes. nullptr keeps the latest one only.
+*
+* @return	The number of magnitudes.
+*/
+int EnvelopeDetector::process(int16_t* env, const int16_t* in, int num)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+	int outputs = 0;
+	int R = 1 << log2r;
+
+	for( ; 0 < num; num--) {
+		// Mix to baseband. x*exp(-j*phase)
+		int idx = phase >> 24;
+		int16_t x = *in++;
+		int32_t i = mult(x, nco_table[(idx + NCO_COS) & 0xFF]);
+		int32_t q = negate(mult(x, nco_table[idx]));
+		phase += step;
+		WMOPS_COUNT(L_add);
+
+		for(int k = 0; k < ENVELOPE_CIC_ORDER; k++) {
+			i = integ[0][k] = wrap_add(integ[0][k], i);
+			q = integ[1][k] = wrap_add(integ[1][k], q);
+		}
+
+		if(R <= ++count) {
+			count = 0;
+			last = decimate();
+			if(nullptr != env) {
+				env[outputs] = last;
+			}
+			outputs++;
+		}
+	}
+
+	return outputs;
+}
+
+int EnvelopeDetector::getEnvelope(int16_t* env, const int16_t* in, int num)
+{
+	return process(env, in, num);
+}
+
+int16_t EnvelopeDetector::getMagnitude(const int16_t* in)
+{
+	process(nullptr, in, N);
+
+	return last;
+}
+
+void EnvelopeDetector::push(const int16_t* in, size_t num)
+{
+	int16_t env[16];
+
+	while(0 < num) {
+		int len = (num < (size_t)(16 << log2r))? num : 16 << log2r;
+		int n = process(env, in, len);
+		in += len;
+		num -= len;
+
+		for(int i = 0; (nullptr != callback) && (i < n); i++) {
+			callback(env[i], user);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+* @brief	Keying edges from the magnitudes. The edge is where the magnitude
+*			crosses the threshold, at the time of the magnitude minus the delay.
+*
+* @return	The number of edges.
+*/
+static int edges(float* edge, const int16_t* mag, int num, float hop, float delay, int16_t threshold)
+{
+	int n = 0;
+	for(int i = 1; i < num; i++) {
+		if((mag[i - 1] < threshold) != (mag[i] < threshold)) {
+			// Interpolated between the magnitudes. mag[i] is at the end of its hop.
+			float t = (float)(threshold - mag[i - 1])/(mag[i] - mag[i - 1]);
+			edge[n++] = (i + t)*hop - delay;
+		}
+	}
+	return n;
+}
+
+int main(int argc, char* argv[])
+{
+	const float fs = 8000;
+	const float tone = 600;
+	const int N = 40;
+	const int R = (1 < argc)? atoi(argv[1]) : 8;
+	const int num = 10*fs;
+
+	// Keyed tone of -6dBFS with the random elements of 20 to 120 ms.
+	int16_t* x = new int16_t[num];
+	float key[256];
+	int keys = 0;
+	bool on = false;
+	srand(1);
+	for(int n = 0, next = 800; n < num; n++) {
+		if(n == next) {
+			key[keys++] = n;
+			on = !on;
+			next += 160 + rand()%800;
+		}
+		x[n] = (on)? F2Q15(0.5*sin(2*M_PI*tone*n/fs)) : 0;
+	}
+
+	// Magnitude of the tone is 0.25.
+	const int16_t threshold = F2Q15(0.125);
+	float edge[256];
+	int16_t* mag = new int16_t[num];
+
+	Goertzel goertzel(tone, fs, N, false);
+	EnvelopeDetector envelope(tone, fs, N, R);
+
+	printf("%-10s %8s %10s %12s %12s\n", "", "rate(Hz)", "us/second", "mean err(ms)", "max err(ms)");
+	for(int d = 0; d < 2; d++) {
+		float hop = (0 == d)? N : envelope.getDecimation();
+		float delay = (0 == d)? N/2.0f : envelope.getDelay();
+		int m = 0;
+
+		clock_t t = clock();
+		for(int rep = 0; rep < 20; rep++) {
+			m = 0;
+			for(int n = 0; n + N <= num; n += N) {
+				if(0 == d) {
+					mag[m++] = goertzel.getMagnitude(x + n);
+				} else {
+					m += envelope.getEnvelope(mag + m, x + n, N);
+				}
+			}
+		}
+		float us = 1e6f*(clock() - t)/CLOCKS_PER_SEC/20/(num/fs);
+
+		int e = edges(edge, mag, m, hop, delay, threshold);
+		float sum = 0, max = 0;
+		for(int i = 0, k = 0; i < e; i++) {
+			while((k + 1 < keys) && (fabs(key[k + 1] - edge[i]) < fabs(key[k] - edge[i]))) {
+				k++;
+			}
+			float err = fabs(edge[i] - key[k])*1000/fs;
+			sum += err;
+			max = (max < err)? err : max;
+		}
+		printf("%-10s %8.0f %10.1f %12.2f %12.2f   %d/%d edges\n", (0 == d)? "Goertzel" : "Envelope",
+				fs/hop, us, sum/e, max, e, keys);
+	}
+
+	delete[] x;
+	delete[] mag;
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,140 @@
+/*==============================================================================
+* @brief	Envelope detector by the NCO mixer and the CIC decimator.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_ENVELOPE_HPP
+#define	_ENVELOPE_HPP
+
+#include "basic_op.h"
+#include "goertzel.hpp"
+
+//******** Configurations ********************************************
+#define	ENVELOPE_CIC_ORDER		3		// Integrator-comb stages.
+#define	ENVELOPE_MAX_LOG2R		5		// R <= 32. The CIC gain R^ORDER must be within 15 bits.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Mixes the tone to baseband by a Q15 NCO and decimates the I/Q by the
+*			CIC filter of ENVELOPE_CIC_ORDER. The magnitude of the baseband is a
+*			continuous envelope at sampling_freq/R, with the same scale as
+*			Goertzel::getMagnitude().
+*
+* @remark	The CIC is sinc^ORDER with the nulls at the multiples of fs/R, so the
+*			noise bandwidth is about fs/R and the image of the mixer at 2*freq
+*			is attenuated. Its group delay is ORDER*(R - 1)/2 input samples.
+*			The integrators and the combs wrap around in 32 bit by design, so
+*			they don't use the saturating Basic Operators. They are counted as
+*			L_add/L_sub for WMOPS.
+*/
+class EnvelopeDetector {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples of getMagnitude().
+	* @param[in] R					Decimation of the CIC. Power of 2, <= 2^ENVELOPE_MAX_LOG2R.
+	*/
+	EnvelopeDetector(float freq = 1000, float sampling_freq = 8000, int N = 128, int R = 8);
+
+	/**
+	* @brief	Set the NCO frequency. The phase and the CIC state are kept.
+	*/
+	void setFreq(float freq, float sampling_freq);
+
+	/**
+	* @brief	Envelope stream.
+	*
+	* @param[out] env		Magnitudes. Q15 format. env[num/R + 1].
+	* @param[in] in			The pointer to input samples. in[num].
+	* @param[in] num		The number of samples.
+	*
+	* @return	The number of magnitudes.
+	*/
+	int getEnvelope(int16_t* env, const int16_t* in, int num);
+
+	/**
+	* @brief	Push N samples, and the latest magnitude of the envelope.
+	*			Same interface as Goertzel::getMagnitude().
+	*
+	* @param[in] in			The pointer to input samples. in[N].
+	*
+	* @return	Magnitude. Q15 format.
+	*/
+	int16_t getMagnitude(const int16_t* in);
+
+	/**
+	* @brief	Set the callback of push(). It is called every R samples.
+	*/
+	void setCallback(Goertzel::MagnitudeCallback cb, void* user_ptr = nullptr)
+	{
+		callback = cb;
+		user = user_ptr;
+	}
+
+	/**
+	* @brief	Streaming input of any chunk size. The callback is called with
+	*			every magnitude of the envelope.
+	*/
+	void push(const int16_t* in, size_t num);
+
+	/**
+	* @brief	Decimation of the CIC.
+	*/
+	int getDecimation(void) const	{ return 1 << log2r; }
+
+	/**
+	* @brief	Group delay of the CIC (samples at sampling_freq).
+	*/
+	float getDelay(void) const		{ return ENVELOPE_CIC_ORDER*((1 << log2r) - 1)/2.0f; }
+
+private:
+	int N;
+	int log2r;
+	int count;			// Samples in the integrators since the last output.
+	int16_t last;		// The latest magnitude.
+
+	uint32_t phase;		// NCO. 2^32 is 2*pi.
+	uint32_t step;
+
+	int32_t integ[2][ENVELOPE_CIC_ORDER];		// I, Q
+	int32_t comb[2][ENVELOPE_CIC_ORDER];
+
+	Goertzel::MagnitudeCallback callback;
+	void* user;
+
+	int process(int16_t* env, const int16_t* in, int num);
+	int16_t decimate(void);
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,452 @@
+/*==============================================================================
+* @brief	Fixed-point real FFT with block floating-point scaling.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include "basic_op.h"
+
+#include "fft.hpp"
+
+
+#define	TWIDDLE_QUARTER		(1 << (FFT_MAX_LOG2N - 2))
+
+/**
+*	sin(2*pi*t/2^FFT_MAX_LOG2N) in Q15. t = 0...2^FFT_MAX_LOG2N/4.
+*/
+static const int16_t sin_table[TWIDDLE_QUARTER + 1] = {
+	    0,   201,   402,   603,   804,  1005,  1206,  1407,
+	 1608,  1809,  2009,  2210,  2411,  2611,  2811,  3012,
+	 3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+	 4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+	 6393,  6590,  6787,  6983,  7180,  7376,  7571,  7767,
+	 7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+	 9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850,
+	11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+	12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+	14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+	15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673,
+	16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+	18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358,
+	19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+	20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+	22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+	23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144,
+	24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+	25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199,
+	26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+	27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+	28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+	28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535,
+	29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+	30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784,
+	30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+	31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+	31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+	32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383,
+	32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+	32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718,
+	32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+	32767,
+};
+
+/**
+* @brief	Twiddle factor exp(-j*2*pi*t/2^FFT_MAX_LOG2N) in Q15.
+*
+* @param[in] t		0 <= t <= 2^FFT_MAX_LOG2N/2.
+*/
+static inline void twiddle(int16_t* wr, int16_t* wi, int t)
+{
+	if(t <= TWIDDLE_QUARTER) {
+		*wr =  sin_table[TWIDDLE_QUARTER - t];
+		*wi = -sin_table[t];
+	} else {
+		*wr = -sin_table[t - TWIDDLE_QUARTER];
+		*wi = -sin_table[2*TWIDDLE_QUARTER - t];
+	}
+}
+
+/**
+* @brief	Right shift of a pass from the max. absolute value of the block.
+*
+* @remark	A pass grows the block by up to 4 times (radix-4) or 1 + sqrt(2)
+*			times (radix-2 and split). Shifting the pass by 3 - norm_s(max)
+*			keeps the block within [-2^14, 2^14 - 1], where the sum of two
+*			samples and the products by the twiddles can't overflow.
+*/
+static inline int16_t passShift(int16_t max)
+{
+	return (0 == max)? 0 : s_max(0, sub(3, norm_s(max)));
+}
+
+/**
+* @brief	Scale an output of a pass, and update the max. absolute value.
+*/
+static inline int16_t scale(int32_t L_v, int16_t shift, int16_t* max)
+{
+	int16_t v = extract_l(L_shr_r(L_v, shift));
+	*max = s_max(*max, abs_s(v));
+	return v;
+}
+
+
+void RealFFT::setSize(int size)
+{
+	log2n = (size < FFT_MIN_LOG2N)? FFT_MIN_LOG2N : (FFT_MAX_LOG2N < size)? FFT_MAX_LOG2N : size;
+	N = 1 << log2n;
+	stride = 1 << (FFT_MAX_LOG2N - log2n);
+}
+
+int16_t RealFFT::transform(int16_t* x)
+{
+	// Normalize the input into [-2^14, 2^14 - 1].
+	int16_t max = 0;
+	for(int i = 0; i < N; i++) {
+		max = s_max(max, abs_s(x[i]));
+	}
+	int16_t sh = (0 == max)? 0 : sub(norm_s(max), 1);
+
+	max = 0;
+	for(int i = 0; i < N; i++) {
+		x[i] = shl(x[i], sh);
+		max = s_max(max, abs_s(x[i]));
+	}
+	int16_t exponent = negate(sh);
+
+	bitReverse(x);
+
+	int16_t s = passShift(max);
+	max = radix4(x, s);
+	exponent = add(exponent, s);
+
+	for(int half = 4; half < N/2; half <<= 1) {
+		s = passShift(max);
+		max = radix2(x, half, s);
+		exponent = add(exponent, s);
+	}
+
+	s = passShift(max);
+	split(x, s);
+
+	return add(exponent, s);
+}
+
+void RealFFT::power(int32_t* power, const int16_t* X) const
+{
+	power[0]	= L_mult(X[0], X[0]);
+	power[N/2]	= L_mult(X[1], X[1]);
+
+	for(int k = 1; k < N/2; k++) {
+		power[k] = L_mac(L_mult(X[2*k], X[2*k]), X[2*k + 1], X[2*k + 1]);
+	}
+}
+
+/**
+* @brief	Bit reversal permutation of N/2 complex samples.
+*/
+void RealFFT::bitReverse(int16_t* z) const
+{
+	int M = N/2;
+
+	for(int i = 0, j = 0; i < M; i++) {
+		if(i < j) {
+			int16_t t;
+			t = z[2*i];		z[2*i] = z[2*j];			z[2*j] = t;
+			t = z[2*i + 1];	z[2*i + 1] = z[2*j + 1];	z[2*j + 1] = t;
+		}
+
+		int bit = M >> 1;
+		for( ; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j |= bit;
+	}
+}
+
+/**
+* @brief	The first 2 stages by radix-4 butterflies. The twiddles are 1 and -j.
+*
+* @return	Max. absolute value of the output.
+*/
+int16_t RealFFT::radix4(int16_t* z, int16_t shift) const
+{
+	int16_t max = 0;
+
+	for(int i = 0; i < N/2; i += 4) {
+		int16_t* p = z + 2*i;
+
+		int32_t pr = L_add(L_deposit_l(p[0]), L_deposit_l(p[2]));	// a + b
+		int32_t pi = L_add(L_deposit_l(p[1]), L_deposit_l(p[3]));
+		int32_t qr = L_sub(L_deposit_l(p[0]), L_deposit_l(p[2]));	// a - b
+		int32_t qi = L_sub(L_deposit_l(p[1]), L_deposit_l(p[3]));
+		int32_t rr = L_add(L_deposit_l(p[4]), L_deposit_l(p[6]));	// c + d
+		int32_t ri = L_add(L_deposit_l(p[5]), L_deposit_l(p[7]));
+		int32_t tr = L_sub(L_deposit_l(p[4]), L_deposit_l(p[6]));	// c - d
+		int32_t ti = L_sub(L_deposit_l(p[5]), L_deposit_l(p[7]));
+
+		p[0] = scale(L_add(pr, rr), shift, &max);		// p + r
+		p[1] = scale(L_add(pi, ri), shift, &max);
+		p[2] = scale(L_add(qr, ti), shift, &max);		// q - j*t
+		p[3] = scale(L_sub(qi, tr), shift, &max);
+		p[4] = scale(L_sub(pr, rr), shift, &max);		// p - r
+		p[5] = scale(L_sub(pi, ri), shift, &max);
+		p[6] = scale(L_sub(qr, ti), shift, &max);		// q + j*t
+		p[7] = scale(L_add(qi, tr), shift, &max);
+	}
+	return max;
+}
+
+/**
+* @brief	A stage by radix-2 butterflies. a' = a + b*W, b' = a - b*W.
+*
+* @param[in] half		Distance of the butterfly. W = exp(-j*pi*i/half).
+*
+* @return	Max. absolute value of the output.
+*/
+int16_t RealFFT::radix2(int16_t* z, int half, int16_t shift) const
+{
+	int16_t max = 0;
+	int step = (1 << FFT_MAX_LOG2N)/(2*half);
+
+	shift = add(shift, 15);
+
+	for(int j = 0; j < half; j++) {
+		int16_t wr, wi;
+		twiddle(&wr, &wi, j*step);
+
+		for(int i = j; i < N/2; i += 2*half) {
+			int16_t* a = z + 2*i;
+			int16_t* b = z + 2*(i + half);
+
+			int32_t tr = L_msu0(L_mult0(b[0], wr), b[1], wi);		// Q30
+			int32_t ti = L_mac0(L_mult0(b[0], wi), b[1], wr);
+			int32_t ar = L_shr(L_deposit_h(a[0]), 1);				// Q30
+			int32_t ai = L_shr(L_deposit_h(a[1]), 1);
+
+			a[0] = scale(L_add(ar, tr), shift, &max);
+			a[1] = scale(L_add(ai, ti), shift, &max);
+			b[0] = scale(L_sub(ar, tr), shift, &max);
+			b[1] = scale(L_sub(ai, ti), shift, &max);
+		}
+	}
+	return max;
+}
+
+/**
+* @brief	Split N/2 complex bins Z[k] into N/2 + 1 real bins X[k].
+*
+* @remark	2*X[k] = E + W*O, 2*X[N/2 - k] = conj(E - W*O).
+*			E = Z[k] + conj(Z[N/2 - k]), O = -j*(Z[k] - conj(Z[N/2 - k])),
+*			W = exp(-j*2*pi*k/N).
+*/
+void RealFFT::split(int16_t* z, int16_t shift) const
+{
+	int M = N/2;
+	int16_t max = 0;
+
+	int16_t zr = z[0];
+	int16_t zi = z[1];
+	z[0] = scale(L_add(L_deposit_l(zr), L_deposit_l(zi)), shift, &max);		// X[0]
+	z[1] = scale(L_sub(L_deposit_l(zr), L_deposit_l(zi)), shift, &max);		// X[N/2]
+
+	shift = add(shift, 15);
+
+	for(int k = 1; k <= M/2; k++) {
+		int16_t* a = z + 2*k;
+		int16_t* b = z + 2*(M - k);
+
+		int16_t er = add(a[0], b[0]);
+		int16_t ei = sub(a[1], b[1]);
+		int16_t or_ = add(a[1], b[1]);
+		int16_t oi = sub(b[0], a[0]);
+
+		int16_t wr, wi;
+		twiddle(&wr, &wi, k*stride);
+
+		int32_t Er = L_shr(L_deposit_h(er), 2);							// Q29
+		int32_t Ei = L_shr(L_deposit_h(ei), 2);
+		int32_t Tr = L_shr(L_msu0(L_mult0(or_, wr), oi, wi), 1);		// Q29
+		int32_t Ti = L_shr(L_mac0(L_mult0(or_, wi), oi, wr), 1);
+
+		b[0] = scale(L_sub(Er, Tr), shift, &max);		// X[N/2 - k]
+		b[1] = scale(L_sub(Ti, Ei), shift, &max);
+		a[0] = scale(L_add(Er, Tr), shift, &max);		// X[k]
+		a[1] = scale(L_add(Ei, Ti), shift, &max);
+	}
+}
+
+//----------------------------------------------------------------------------------
+#ifdef	MODULE_DEBUG
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "goertzel.hpp"
+
+static double elapsed_ns(const struct timespec* t0, const struct timespec* t1)
+{
+	return (t1->tv_sec - t0->tv_sec)*1e9 + (t1->tv_nsec - t0->tv_nsec);
+}
+
+/**
+* @brief	SNR (dB) of the FFT against the DFT in double.
+*/
+static double snr(RealFFT& fft, const int16_t* in)
+{
+	int N = fft.getSize();
+	int16_t* x = new int16_t[N];
+	for(int n = 0; n < N; n++) {
+		x[n] = in[n];
+	}
+	int16_t exponent = fft.transform(x);
+
+	double sig = 0, err = 0;
+	for(int k = 0; k <= N/2; k++) {
+		double re = 0, im = 0;
+		for(int n = 0; n < N; n++) {
+			re += in[n]*cos(2*M_PI*k*n/N);
+			im -= in[n]*sin(2*M_PI*k*n/N);
+		}
+
+		double fr, fi;
+		if(0 == k) {
+			fr = x[0];		fi = 0;
+		} else if(N/2 == k) {
+			fr = x[1];		fi = 0;
+		} else {
+			fr = x[2*k];	fi = x[2*k + 1];
+		}
+		fr = ldexp(fr, exponent);
+		fi = ldexp(fi, exponent);
+
+		sig += re*re + im*im;
+		err += (fr - re)*(fr - re) + (fi - im)*(fi - im);
+	}
+	delete[] x;
+
+	return 10*log10(sig/((0 < err)? err : 1e-30));
+}
+
+int main(int argc, char* argv[])
+{
+	const float fs = 8000;
+	const int loops = (1 < argc)? atoi(argv[1]) : 2000;
+
+	srand(1);
+
+	printf("log2n  SNR(noise) SNR(tone) SNR(full scale)\n");
+	for(int log2n = FFT_MIN_LOG2N; log2n <= FFT_MAX_LOG2N; log2n++) {
+		RealFFT fft(log2n);
+		int N = fft.getSize();
+		int16_t* in = new int16_t[N];
+
+		double s[3];
+		for(int n = 0; n < N; n++) {
+			in[n] = (rand() & 0x7FFF) - 0x4000;
+		}
+		s[0] = snr(fft, in);
+		for(int n = 0; n < N; n++) {
+			in[n] = F2Q15(0.01f*sin(2*M_PI*600.0f*n/fs) + 0.001f*((rand() & 0xFF) - 128)/128.0f);
+		}
+		s[1] = snr(fft, in);
+		for(int n = 0; n < N; n++) {
+			in[n] = (n & 1)? INT16_MIN : INT16_MAX;
+		}
+		s[2] = snr(fft, in);
+
+		printf("%5d %8.1f dB %8.1f dB %8.1f dB\n", log2n, s[0], s[1], s[2]);
+		delete[] in;
+	}
+
+	// Benchmark: a spectrum of N/2 + 1 bins by RealFFT and by N/2 + 1 Goertzels.
+	const int log2n = 8;
+	const int N = 1 << log2n;
+	RealFFT fft(log2n);
+
+	int16_t in[N], x[N];
+	int32_t power[N/2 + 1];
+	for(int n = 0; n < N; n++) {
+		in[n] = F2Q15(0.5f*sin(2*M_PI*609.375f*n/fs) + 0.01f*((rand() & 0xFF) - 128)/128.0f);
+	}
+
+	Goertzel* goertzel = new Goertzel[N/2 + 1];
+	for(int k = 0; k <= N/2; k++) {
+		goertzel[k].setFreq(k*fs/N, fs, N, true);
+	}
+
+	struct timespec t0, t1, t2;
+	int16_t exponent = 0;
+	volatile int32_t sink = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(int l = 0; l < loops; l++) {
+		for(int n = 0; n < N; n++) {
+			x[n] = in[n];
+		}
+		exponent = fft.transform(x);
+		fft.power(power, x);
+		sink += power[l & (N/2)];
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	for(int l = 0; l < loops; l++) {
+		for(int k = 0; k <= N/2; k++) {
+			sink += goertzel[k].getSquaredMagnitude(in);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	// Magnitudes |X[k]|/N compared with the DFT in double.
+	double fft_err = 0, goertzel_err = 0;
+	for(int k = 1; k < N/2; k++) {
+		double re = 0, im = 0;
+		for(int n = 0; n < N; n++) {
+			re += in[n]*cos(2*M_PI*k*n/N);
+			im -= in[n]*sin(2*M_PI*k*n/N);
+		}
+		double ref = sqrt(re*re + im*im)/N;
+
+		double fftmag = sqrt((double)power[k])*ldexp(1.0, exponent)/N;
+		double gmag = Goertzel::magnitude(goertzel[k].getSquaredMagnitude(in));
+		fft_err = fmax(fft_err, fabs(fftmag - ref));
+		goertzel_err = fmax(goertzel_err, fabs(gmag - ref));
+	}
+	delete[] goertzel;
+
+	double ns_fft = elapsed_ns(&t0, &t1)/loops;
+	double ns_goertzel = elapsed_ns(&t1, &t2)/loops;
+	printf("\nN=%d, %d bins: RealFFT %.0f ns, %d Goertzels %.0f ns (x%.1f)\n", N, N/2 + 1, ns_fft, N/2 + 1, ns_goertzel, ns_goertzel/ns_fft);
+	printf("Max. error of magnitude: RealFFT %.1f LSB, Goertzel %.1f LSB (Q15)\n", fft_err, goertzel_err);
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,106 @@
+/*==============================================================================
+* @brief	Fixed-point real FFT with block floating-point scaling.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_FFT_HPP
+#define	_FFT_HPP
+
+#include <stdint.h>
+
+//******** Configurations ********************************************
+#define	FFT_MIN_LOG2N		3		// N >= 8
+#define	FFT_MAX_LOG2N		10		// N <= 1024. Size of the twiddle table.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Real FFT of N samples with the Basic Operators.
+*
+* @remark	The N real samples are transformed in place as N/2 complex samples
+*			(even samples are real, odd samples are imaginary parts). After the
+*			bit reversal, the first 2 stages are done by radix-4 butterflies
+*			without multiplication, the rest by radix-2 butterflies with Q15
+*			twiddles, and the N/2 complex bins are split into N/2 + 1 real
+*			bins. Before every pass, the block is checked by norm_s() and
+*			shifted only as much as the pass can grow (block floating-point).
+*/
+class RealFFT {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] log2n		N = 2^log2n. FFT_MIN_LOG2N <= log2n <= FFT_MAX_LOG2N.
+	*/
+	RealFFT(int log2n = 8) {
+		setSize(log2n);
+	}
+
+	/**
+	* @brief	Set N = 2^log2n. It is clamped to [FFT_MIN_LOG2N, FFT_MAX_LOG2N].
+	*/
+	void setSize(int log2n);
+
+	/**
+	* @brief	The number of real samples.
+	*/
+	int getSize(void) const		{ return N; }
+
+	/**
+	* @brief	Transform in place.
+	*
+	* @param[in,out] x		In: N real samples. Q15.
+	*						Out: x[0] = Re X[0], x[1] = Re X[N/2],
+	*						x[2k] = Re X[k], x[2k + 1] = Im X[k] (0 < k < N/2).
+	*
+	* @return	Block exponent. X[k] = sum(x[n]*exp(-j*2*pi*k*n/N)) = x[]*2^exponent.
+	*/
+	int16_t transform(int16_t* x);
+
+	/**
+	* @brief	Power spectrum of the output of transform().
+	*
+	* @param[out] power		|X[k]|^2 in Q31. power[N/2 + 1]. = power[]*2^(2*exponent).
+	* @param[in] X			Output of transform(). X[N].
+	*/
+	void power(int32_t* power, const int16_t* X) const;
+
+private:
+	int N;
+	int log2n;
+	int stride;			// Stride of the twiddle table. = 2^FFT_MAX_LOG2N/N.
+
+	void bitReverse(int16_t* z) const;
+	int16_t radix4(int16_t* z, int16_t shift) const;
+	int16_t radix2(int16_t* z, int half, int16_t shift) const;
+	void split(int16_t* z, int16_t shift) const;
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -29,6 +29,8 @@
 *
 */
 #include <cmath>
+#include <complex>
+#include <algorithm>
 #include <assert.h>
 	
 #include "basic_op.h"
@@ -51,7 +53,7 @@
 */
 void IIRFilter1::setFreq(float cutoff, float sample_freq, FILTER_TYPE type)
 {
-	float numa[2], dena[2], numd[2], dend[2];
+	float numa[2], dena[2], numd[2], dend[2], work[BILINEAR_WORK_SIZE(2)];
 
 	float T = 1.0/sample_freq;
 	float wp = bilinear_prewarp(2*M_PI*cutoff, T);
@@ -69,129 +71,304 @@ void IIRFilter1::setFreq(float cutoff, float sample_freq, FILTER_TYPE type)
 	}
 	dena[0] = wp;	dena[1] = 1.0;
 
-	bilinear(numd, dend, numa, dena, sizeof(dend)/sizeof(dend[0]), T);
+	bilinear_r(numd, dend, numa, dena, sizeof(dend)/sizeof(dend[0]), T, work);
 
-	b0 = F2Q15( numd[0]);
-	b1 = F2Q15( numd[1]);
-	a1 = F2Q15(-dend[1]);
+	coef.b0 = F2Q15( numd[0]);
+	coef.b1 = F2Q15( numd[1]);
+	coef.a1 = F2Q15(-dend[1]);
 
 #ifdef	MODULE_DEBUG
 	printf("\nfp=%f\n", wp/2.0/M_PI);
 
-	printf("b0=%+f\n", b0/32768.f);
-	printf("b1=%+f\n", b1/32768.f);
-	printf("a1=%+f\n", a1/32768.f);
+	printf("b0=%+f\n", coef.b0/32768.f);
+	printf("b1=%+f\n", coef.b1/32768.f);
+	printf("a1=%+f\n", coef.a1/32768.f);
 #endif
 }
 
 /**
-* @brief	Filtering n samples.
+* @brief	Set coefficients from cutoff frequency in Hz. 
 *
-* @param[out] out		Teh pointer to Q15 or Q31 output buffer. out[num].
-* @param[in] in			The pointer to Q15 input buffer. in[num].
-* @param[in] num		The number of samples.
+* @param[in] cutoff			Cutoff frequency in Hz.
+* @param[in] sample_freq	Sampling frequency in Hz.
+* @param[in] type
+* @param[in] Q				Filter Q
 */
-void IIR1DirectFormI::filter(int16_t* out, const int16_t* in, int num)
+void IIRFilter2::setFreq(float cutoff, float sample_freq, FILTER_TYPE type, float Q)
 {
-	for( ; 0 < num; num--) {
-		*out++ = round_fx(convol(*in++));
+	design(&coef, &cutoff, 1, sample_freq, type, Q);
+
+#ifdef	MODULE_DEBUG
+	printf("\nfp=%f\n", bilinear_prewarp(2*M_PI*cutoff, 1.0/sample_freq)/2.0/M_PI);
+
+	printf("b0=%+f\n", coef.b0/16384.f);
+	printf("b1=%+f\n", coef.b1/16384.f);
+	printf("b2=%+f\n", coef.b2/16384.f);
+	printf("a1=%+f\n", coef.a1/16384.f);
+	printf("a2=%+f\n", coef.a2/16384.f);
+#endif
+}
+
+/**
+* @brief	Design of num filters of the same type, for a bank of the cutoff frequencies.
+*			The coefficients are the same as setFreq(). No heap.
+*
+* @param[out] coef		Q14 coefficients. coef[num].
+* @param[in] cutoff		Cutoff (or center) frequencies (Hz). cutoff[num].
+* @param[in] num		Number of filters.
+* @param[in] sample_freq	Sampling frequency (Hz).
+* @param[in] type		FILTER_TYPE_LPF, FILTER_TYPE_BPF, FILTER_TYPE_HPF or FILTER_TYPE_BEF.
+* @param[in] Q			Quality factor.
+*/
+void IIRFilter2::design(IIR2Coefficients* coef, const float* cutoff, int num, float sample_freq, FILTER_TYPE type, float Q)
+{
+	float numa[IIR_DESIGN_CHUNK][3], dena[IIR_DESIGN_CHUNK][3];
+	float numd[IIR_DESIGN_CHUNK][3], dend[IIR_DESIGN_CHUNK][3];
+	float work[BILINEAR_WORK_SIZE(3)];
+
+	float T = 1.0/sample_freq;
+
+	while(0 < num) {
+		int n = (num < IIR_DESIGN_CHUNK)? num : IIR_DESIGN_CHUNK;
+
+		for(int i = 0; i < n; i++) {
+			float wp = bilinear_prewarp(2*M_PI*cutoff[i], T);
+
+			switch(type) {
+			case FILTER_TYPE_LPF:	// H(s) = wp^2/(wp^2 + 1/Q*wp*s + s^2)
+				numa[i][0] = wp*wp;	numa[i][1] = 0.0;		numa[i][2] = 0.0;
+				break;
+			case FILTER_TYPE_BPF:	// H(s) = (1/Q*wp*s)/(wp^2 + 1/Q*wp*s + s^2)
+				numa[i][0] = 0.0;	numa[i][1] = 1/Q*wp;	numa[i][2] = 0.0;
+				break;
+			case FILTER_TYPE_HPF:	// H(s) = s^2/(wp^2 + 1/Q*wp*s + s^2)
+				numa[i][0] = 0.0;	numa[i][1] = 0.0;		numa[i][2] = 1.0;
+				break;
+			case FILTER_TYPE_BEF:	// H(s) = (wp*wp + w^2)/(wp^2 + 1/Q*wp*s + s^2)
+				numa[i][0] = wp*wp;	numa[i][1] = 0.0;		numa[i][2] = 1.0;
+				break;
+			default:
+				assert(false);
+				break;
+			}
+			dena[i][0] = wp*wp;	dena[i][1] = 1/Q*wp;	dena[i][2] = 1.0;
+		}
+
+		bilinear_batch(numd[0], dend[0], numa[0], dena[0], 3, n, T, work);
+
+		for(int i = 0; i < n; i++) {
+			coef[i].b0 = F2Q14( numd[i][0]);
+			coef[i].b1 = F2Q14( numd[i][1]);
+			coef[i].b2 = F2Q14( numd[i][2]);
+			coef[i].a1 = F2Q14(-dend[i][1]);
+			coef[i].a2 = F2Q14(-dend[i][2]);
+		}
+
+		coef += n;
+		cutoff += n;
+		num -= n;
 	}
 }
 
-void IIR1DirectFormI::filter(int32_t* out, const int16_t* in, int num)
+/**
+* @brief	Filtering n samples through the first m sections in place.
+*/
+void IIRCascade::filter_sections(int16_t* out, const int16_t* in, int num, int m)
 {
-	for( ; 0 < num; num--) {
-		*out++ = convol(*in++);
+	section[0].filter(out, in, num);
+	for(int n = 1; n < m; n++) {
+		section[n].filter(out, out, num);
 	}
 }
 
 /**
-* @brief	Convolution.
-*
-* @param[in] in		Q15 input.
+* @brief	Filtering n samples through all sections.
 *
-* @return	Q31 output.
+* @param[out] out		The pointer to Q15 or Q31 output buffer. out[num].
+* @param[in] in			The pointer to Q15 input buffer. in[num].
+* @param[in] num		The number of samples.
 */
-int32_t IIR1DirectFormI::convol(int16_t in)
+void IIRCascade::filter(int16_t* out, const int16_t* in, int num)
 {
-	int32_t acc = L_mult(round_fx(fb0),	a1);
-	acc = L_mac(acc,	ff0,			b1);
-	acc = L_mac(acc,	ff0 = in,		b0);
+	filter_sections(out, in, num, sections);
+}
+
+void IIRCascade::filter(int32_t* out, const int16_t* in, int num)
+{
+	if(1 == sections) {
+		section[0].filter(out, in, num);
+		return;
+	}
+
+	int16_t buf[IIR_CASCADE_CHUNK];		// Q15 outputs of the sections but the last.
 
-	return (fb0 = acc);
+	while(0 < num) {
+		int n = std::min(num, IIR_CASCADE_CHUNK);
+
+		filter_sections(buf, in, n, sections - 1);
+		section[sections - 1].filter(out, buf, n);
+
+		in += n;
+		out += n;
+		num -= n;
+	}
 }
 
+/**
+*	Poles of the Bessel lowpass prototype normalized to -3dB at 1 rad/s.
+*	{Re, Im} of the poles with Im >= 0 for the order 1 to IIR_CASCADE_MAX_SECTIONS.
+*/
+static const double bessel_pole[IIR_CASCADE_MAX_SECTIONS][(IIR_CASCADE_MAX_SECTIONS + 1)/2][2] = {
+	{ { -1.0000000000, 0.0000000000 } },
+	{ { -1.1016013306, 0.6360098248 } },
+	{ { -1.0474091610, 0.9992644363 }, { -1.3226757999, 0.0000000000 } },
+	{ { -0.9952087644, 1.2571057395 }, { -1.3700678306, 0.4102497175 } },
+	{ { -0.9576765486, 1.4711243207 }, { -1.3808773259, 0.7179095876 }, { -1.5023162714, 0.0000000000 } },
+	{ { -0.9306565229, 1.6618632689 }, { -1.3818580976, 0.9714718907 }, { -1.5714904036, 0.3208963742 } },
+	{ { -0.9098677806, 1.8364513530 }, { -1.3789032168, 1.1915667778 }, { -1.6120387662, 0.5892445069 }, { -1.6843681793, 0.0000000000 } },
+	{ { -0.8928697188, 1.9983258436 }, { -1.3738412176, 1.3883565759 }, { -1.6369394181, 0.8227956251 }, { -1.7574084004, 0.2728675751 } },
+};
 
 /**
-* @brief	Set coefficients from cutoff frequency in Hz. 
+* @brief	Poles of the lowpass prototype with the cutoff at 1 rad/s.
 *
-* @param[in] cutoff			Cutoff frequency in Hz.
-* @param[in] sample_freq	Sampling frequency in Hz.
-* @param[in] type
-* @param[in] Q				Filter Q
+* @param[out] pole		Poles with Im >= 0. pole[(order + 1)/2]. A real pole has Im = 0.
+* @param[in] order
+* @param[in] design
+* @param[in] ripple		Passband ripple in dB for IIR_DESIGN_CHEBYSHEV.
+*
+* @return	The number of poles.
 */
-void IIRFilter2::setFreq(float cutoff, float sample_freq, FILTER_TYPE type, float Q)
+static int prototype(std::complex<double>* pole, int order, IIR_DESIGN design, float ripple)
 {
-	float numa[3], dena[3], numd[3], dend[3];
-
-	float T = 1.0/sample_freq;
-	float wp = bilinear_prewarp(2*M_PI*cutoff, T);
+	int n = (order + 1)/2;
 
-	switch(type) {
-	case FILTER_TYPE_LPF:	// H(s) = wp^2/(wp^2 + 1/Q*wp*s + s^2)
-		numa[0] = wp*wp;	numa[1] = 0.0;		numa[2] = 0.0;
-		break;
-	case FILTER_TYPE_BPF:	// H(s) = (1/Q*wp*s)/(wp^2 + 1/Q*wp*s + s^2)
-		numa[0] = 0.0;		numa[1] = 1/Q*wp;	numa[2] = 0.0;
-		break;
-	case FILTER_TYPE_HPF:	// H(s) = s^2/(wp^2 + 1/Q*wp*s + s^2)
-		numa[0] = 0.0;		numa[1] = 0.0;		numa[2] = 1.0;
-		break;
-	case FILTER_TYPE_BEF:	// H(s) = (wp*wp + w^2)/(wp^2 + 1/Q*wp*s + s^2)
-		numa[0] = wp*wp;	numa[1] = 0.0;		numa[2] = 1.0;
-	default:
-		assert(false);
-		break;
+	double sigma = 1.0, omega = 1.0;
+	if(IIR_DESIGN_CHEBYSHEV == design) {
+		double mu = asinh(1.0/sqrt(pow(10.0, ripple/10.0) - 1.0))/order;
+		sigma = sinh(mu);
+		omega = cosh(mu);
 	}
-	dena[0] = wp*wp;	dena[1] = 1/Q*wp;	dena[2] = 1.0;
 
-	bilinear(numd, dend, numa, dena, sizeof(dend)/sizeof(dend[0]), T);
+	for(int k = 0; k < n; k++) {
+		double theta = M_PI*(2*k + 1)/(2*order);
+
+		switch(design) {
+		case IIR_DESIGN_BUTTERWORTH:
+		case IIR_DESIGN_CHEBYSHEV:
+			pole[k] = std::complex<double>(-sigma*sin(theta), (2*k + 1 == order)? 0.0 : omega*cos(theta));
+			break;
+		case IIR_DESIGN_BESSEL:
+			pole[k] = std::complex<double>(bessel_pole[order - 1][k][0], bessel_pole[order - 1][k][1]);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
 
-	b0 = F2Q14( numd[0]);
-	b1 = F2Q14( numd[1]);
-	b2 = F2Q14( numd[2]);
-	a1 = F2Q14(-dend[1]);
-	a2 = F2Q14(-dend[2]);
+	return n;
+}
 
-#ifdef	MODULE_DEBUG
-	printf("\nfp=%f\n", wp/2.0/M_PI);
+/**
+* @brief	|H(e^jw)| of the 2nd order section.
+*/
+static double magnitude(const float* num, const float* den, double w)
+{
+	std::complex<double> z1 = std::polar(1.0, -w);
+	std::complex<double> z2 = z1*z1;
 
-	printf("b0=%+f\n", b0/16384.f);
-	printf("b1=%+f\n", b1/16384.f);
-	printf("b2=%+f\n", b2/16384.f);
-	printf("a1=%+f\n", a1/16384.f);
-	printf("a2=%+f\n", a2/16384.f);
-#endif
+	return abs(((double)num[0] + (double)num[1]*z1 + (double)num[2]*z2)
+				/((double)den[0] + (double)den[1]*z1 + (double)den[2]*z2));
 }
 
+#define	BANDPASS_GRID		512		// Frequency points to find the peak gain.
+#define	BANDPASS_HEADROOM	0.5		// Peak gain. The overshoot of the high Q sections to the keying must not saturate.
+
 /**
-* @brief	Convolution.
+* @brief	Set coefficients from the center frequency and the bandwidth in Hz.
 *
-* @param[in] in		Q15 input.
+* @param[in] center			Center frequency in Hz.
+* @param[in] bandwidth		Bandwidth in Hz.
+* @param[in] sample_freq	Sampling frequency in Hz.
+* @param[in] order			Order of the lowpass prototype. = The number of sections.
+* @param[in] design
+* @param[in] ripple			Passband ripple in dB for IIR_DESIGN_CHEBYSHEV.
 *
-* @return	Q31 output.
+* @remark	Each pole p of the lowpass prototype is transformed by s -> (s^2 + w0^2)/(B*s),
+*			where w0^2 = wl*wh and B = wh - wl of the prewarped band edges.
+*			H(s) = B*s/(s^2 - 2*Re(q)*s + |q|^2) for each pole q of the bandpass.
 */
-int32_t IIR2DirectFormI::convol(int16_t in)
+void IIRBandpass::setFreq(float center, float bandwidth, float sample_freq, int order, IIR_DESIGN design, float ripple)
 {
-	int32_t acc =	 L_shl(L_mult(round_fx(fb1),	a2), 15 - 14);
-	acc = L_add(acc, L_shl(L_mult(round_fx(fb0),	a1), 15 - 14));
-	acc = L_add(acc, L_shl(L_mult(ff1,				b2), 15 - 14));
-	acc = L_add(acc, L_shl(L_mult(ff0,				b1), 15 - 14));
-	ff1 = ff0;
-	acc = L_add(acc, L_shl(L_mult(ff0 = in,			b0), 15 - 14));
-	fb1 = fb0;
-
-	return (fb0 = acc);
+	assert((0 < order) && (order <= IIR_CASCADE_MAX_SECTIONS));
+	sections = order;
+
+	float T = 1.0/sample_freq;
+	double wl = bilinear_prewarp(2*M_PI*(center - bandwidth/2), T);
+	double wh = bilinear_prewarp(2*M_PI*(center + bandwidth/2), T);
+	double w0 = sqrt(wl*wh);
+	double B = wh - wl;
+
+	// Analog sections.
+	std::complex<double> pole[(IIR_CASCADE_MAX_SECTIONS + 1)/2];
+	std::complex<double> q[IIR_CASCADE_MAX_SECTIONS];
+	int n = 0;
+
+	for(int k = prototype(pole, order, design, ripple) - 1; 0 <= k; k--) {
+		std::complex<double> pb = pole[k]*B/2.0;
+		std::complex<double> d = sqrt(pb*pb - w0*w0);
+
+		q[n++] = pb + d;
+		if(0.0 != pole[k].imag()) {
+			q[n++] = pb - d;
+		}
+	}
+
+	// Digital sections.
+	float numa[IIR_CASCADE_MAX_SECTIONS][3], dena[IIR_CASCADE_MAX_SECTIONS][3];
+	float numd[IIR_CASCADE_MAX_SECTIONS][3], dend[IIR_CASCADE_MAX_SECTIONS][3];
+	float work[BILINEAR_WORK_SIZE(3)];
+
+	for(n = 0; n < sections; n++) {
+		numa[n][0] = 0.0;					numa[n][1] = B;						numa[n][2] = 0.0;
+		dena[n][0] = norm(q[n]);			dena[n][1] = -2*q[n].real();		dena[n][2] = 1.0;
+	}
+	bilinear_batch(numd[0], dend[0], numa[0], dena[0], 3, sections, T, work);
+
+	// Scale each section so that the peak gain of the cascade up to it is BANDPASS_HEADROOM.
+	double wmin = 2*M_PI*T*std::max(0.0f, center - 2*bandwidth);
+	double wmax = 2*M_PI*T*std::min(sample_freq/2, center + 2*bandwidth);
+	double gain[BANDPASS_GRID];
+
+	for(int i = 0; i < BANDPASS_GRID; i++) {
+		gain[i] = 1.0;
+	}
+
+	for(n = 0; n < sections; n++) {
+		double peak = 0.0;
+		for(int i = 0; i < BANDPASS_GRID; i++) {
+			gain[i] *= magnitude(numd[n], dend[n], wmin + (wmax - wmin)*i/(BANDPASS_GRID - 1));
+			peak = std::max(peak, gain[i]);
+		}
+		peak /= BANDPASS_HEADROOM;
+		for(int i = 0; i < BANDPASS_GRID; i++) {
+			gain[i] /= peak;
+		}
+
+		IIR2Coefficients c;
+		c.b0 = F2Q14( numd[n][0]/peak);
+		c.b1 = F2Q14( numd[n][1]/peak);
+		c.b2 = F2Q14( numd[n][2]/peak);
+		c.a1 = F2Q14(-dend[n][1]);
+		c.a2 = F2Q14(-dend[n][2]);
+		section[n].setCoefficients(c);
+
+#ifdef	MODULE_DEBUG
+		printf("section %d: q=%+f%+fj peak=%f b0=%+f a1=%+f a2=%+f\n", n, q[n].real(), q[n].imag(), peak,
+				c.b0/16384.f, c.a1/16384.f, c.a2/16384.f);
+#endif
+	}
 }
 
 //----------------------------------------------------------------------------------
@@ -214,6 +391,32 @@ int main(int argc, char* argv[])
 	lpf1.filter(out, in, 16);
 	bpf2.filter(out, in, 16);
 
+	// Response of the fixed-point bandpass cascades to a sine of -6dBFS.
+	IIRBandpass bpf[NUMOF_IIR_DESIGN];
+	for(int d = 0; d < NUMOF_IIR_DESIGN; d++) {
+		bpf[d].setFreq(600, 200, 8000, 4, (IIR_DESIGN)d);
+	}
+
+	printf("\n  Hz  Butterworth  Chebyshev     Bessel (dB)\n");
+	for(int f = 300; f <= 900; f += 25) {
+		printf("%4d", f);
+		for(int d = 0; d < NUMOF_IIR_DESIGN; d++) {
+			int16_t x[200];
+			int peak = 0;
+			for(int t = 0; t < 8000; t += 200) {
+				for(int i = 0; i < 200; i++) {
+					x[i] = 16384*sin(2*M_PI*f*(t + i)/8000);
+				}
+				bpf[d].filter(x, x, 200);
+				for(int i = 0; (4000 <= t) && (i < 200); i++) {
+					peak = std::max(peak, abs(x[i]));
+				}
+			}
+			printf(" %10.2f", 20*log10((peak + 0.5)/16384.0));
+		}
+		printf("\n");
+	}
+
 	return 0;
 }
 
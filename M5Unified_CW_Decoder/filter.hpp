@@ -31,6 +31,21 @@
 #ifndef	_FILTER_HPP
 #define	_FILTER_HPP
 
+#include <assert.h>
+
+#include "basic_op.h"
+#include "bilinear.h"
+#include "f2q.h"
+
+//******** Configurations ********************************************
+//--------	The maximum number of the 2nd order sections of IIRCascade.
+#define	IIR_CASCADE_MAX_SECTIONS	8
+//--------	Samples per pass of IIRCascade with Q31 outputs.
+#define	IIR_CASCADE_CHUNK			64
+//--------	Filters per pass of IIRFilter2::design().
+#define	IIR_DESIGN_CHUNK			16
+//--------------------------------------------------------------------
+
 typedef enum {
 	FILTER_TYPE_LPF = 0,
 	FILTER_TYPE_BPF,
@@ -40,42 +55,146 @@ typedef enum {
 	NUMOF_FILTER_TYPE
 } FILTER_TYPE;
 
+/**
+* @brief	Coefficients of the 1st and 2nd order IIR filter.
+*			b2 and a2 are not used by the 1st order.
+*/
+struct IIR2Coefficients {
+	int16_t b0, b1, b2;
+	int16_t a1, a2;
+};
+
 
-class IIR1DirectFormI {
+/**
+* @brief	Direct form I IIR filter.
+*
+* @description		H(z) = (b0 + b1*z^-1 + b2*z^-2)/(1 - a1*z^-1 - a2*z^-2)
+*
+* @tparam ORDER		1 or 2.
+* @tparam Qn		Q format of the coefficients.
+* @tparam GUARD		Accumulate the products with 15 - Qn guard bits and scale once at
+*					the end, so the partial sums don't saturate.
+*
+* @remark	No virtual function. filter() copies the coefficients and the delay
+*			line to locals, so they are kept in registers for the whole block.
+*/
+template <int ORDER, int Qn, bool GUARD = false>
+class IIRDirectFormI {
 	public:
-		/**
-		* @brief Constructor
-		*
-		* @param b0		Q15
-		* @param b1		Q15
-		* @param a1		Q15
-		*/
-		IIR1DirectFormI(int16_t b0 = 0x7FFF, int16_t b1 = 0, int16_t a1 = 0) : 
-									b0(b0), b1(b1), a1(a1), ff0(0), fb0(0)	{ ; }
+		constexpr IIRDirectFormI(const IIR2Coefficients& c = IIR2Coefficients{ (15 == Qn)? 0x7FFF : (1 << Qn), 0, 0, 0, 0 }) :
+									coef(c), state{0, 0, 0, 0} { ; }
 
 		/**
 		* @brief	Filtering n samples.
 		*
-		* @description		H(z) = (b0 + b1*z^-1)/(1 - a1*z^-1)
-		*
 		* @param out	The pointer to output. out[num].
 		* @param in		The pointer to input. in[num].
 		* @param num	The number of output/input.
 		*/
-		void filter(int16_t* out, const int16_t* in, int num);	// Q15 outputs.
-		void filter(int32_t* out, const int16_t* in, int num);	// Q31 outputs.
+		void filter(int16_t* out, const int16_t* in, int num)	// Q15 outputs.
+		{
+			WMOPS_STAGE_SCOPE(WMOPS_STAGE_BPF);
+
+			const IIR2Coefficients c = coef;
+			State s = state;
+			for( ; 0 < num; num--) {
+				*out++ = round_fx(convol(s, c, *in++));
+			}
+			state = s;
+		}
+
+		void filter(int32_t* out, const int16_t* in, int num)	// Q31 outputs.
+		{
+			WMOPS_STAGE_SCOPE(WMOPS_STAGE_BPF);
+
+			const IIR2Coefficients c = coef;
+			State s = state;
+			for( ; 0 < num; num--) {
+				*out++ = convol(s, c, *in++);
+			}
+			state = s;
+		}
+
+		/**
+		* @brief	Set coefficients. The delay line is kept, so the filter can be
+		*			retuned while running without a glitch.
+		*/
+		void setCoefficients(const IIR2Coefficients& c)		{ coef = c; }
+
+		IIR2Coefficients getCoefficients(void) const		{ return coef; }
 
 	protected:
-		// Coefficients
-		int16_t b0, b1;
-		int16_t a1;
-		
-		// Delay line buffer
-		int16_t	ff0;
-		int32_t fb0;
+		IIR2Coefficients coef;		// Qn
 
 	private:
-		virtual int32_t convol(int16_t in);
+		// Delay line buffer
+		struct State {
+			int16_t ff0, ff1;
+			int32_t fb0, fb1;
+		} state;
+
+		/**
+		* @brief	x*c for the coefficient in Qn. Q31 output, or Q(Qn + 16) with GUARD.
+		*/
+		static int32_t multQ(int16_t x, int16_t c)
+		{
+			return (GUARD || (15 == Qn))? L_mult(x, c) : L_shl(L_mult(x, c), 15 - Qn);
+		}
+
+		/**
+		* @brief	acc + x*c for the coefficient in Qn. Q31 output, or Q(Qn + 16) with GUARD.
+		*/
+		static int32_t macQ(int32_t acc, int16_t x, int16_t c)
+		{
+			return (GUARD || (15 == Qn))? L_mac(acc, x, c) : L_add(acc, multQ(x, c));
+		}
+
+		/**
+		* @brief	Convolution.
+		*
+		* @param[in] in		Q15 input.
+		*
+		* @return	Q31 output.
+		*/
+		static int32_t convol(State& s, const IIR2Coefficients& c, int16_t in)
+		{
+			int32_t acc;
+			if(2 == ORDER) {
+				acc = multQ(round_fx(s.fb1), c.a2);
+				acc = macQ(acc, round_fx(s.fb0), c.a1);
+				acc = macQ(acc, s.ff1, c.b2);
+			} else {
+				acc = multQ(round_fx(s.fb0), c.a1);
+			}
+			acc = macQ(acc, s.ff0, c.b1);
+			if(2 == ORDER) {
+				s.ff1 = s.ff0;
+			}
+			acc = macQ(acc, s.ff0 = in, c.b0);
+			if(GUARD && (15 != Qn)) {
+				acc = L_shl(acc, 15 - Qn);
+			}
+			if(2 == ORDER) {
+				s.fb1 = s.fb0;
+			}
+
+			return (s.fb0 = acc);
+		}
+};
+
+
+class IIR1DirectFormI : public IIRDirectFormI<1, 15> {
+	public:
+		/**
+		* @brief Constructor
+		*
+		* @param b0		Q15
+		* @param b1		Q15
+		* @param a1		Q15
+		*/
+		constexpr IIR1DirectFormI(int16_t b0 = 0x7FFF, int16_t b1 = 0, int16_t a1 = 0) :
+									IIRDirectFormI(IIR2Coefficients{ b0, b1, 0, a1, 0 })	{ ; }
+		constexpr IIR1DirectFormI(const IIR2Coefficients& c) : IIRDirectFormI(c)			{ ; }
 };
 
 class IIRFilter1 : public IIR1DirectFormI {
@@ -84,11 +203,46 @@ class IIRFilter1 : public IIR1DirectFormI {
 			setFreq(cutoff, sample_freq, type);
 		}
 
+		/**
+		* @brief Constructor with the coefficients designed by coefficients(). No design at run time.
+		*/
+		constexpr IIRFilter1(const IIR2Coefficients& c) : IIR1DirectFormI(c)	{ ; }
+
 		void setFreq(float cutoff, float sample_freq, FILTER_TYPE type);
+
+		/**
+		* @brief	The same design as setFreq(), evaluated at compile time.
+		*
+		* @param cutoff			Cutoff frequency (Hz).
+		* @param sample_freq	Sampling frequency (Hz).
+		* @param type			FILTER_TYPE_LPF or FILTER_TYPE_HPF.
+		*
+		* @return	Q15 coefficients.
+		*/
+		static constexpr IIR2Coefficients coefficients(float cutoff, float sample_freq, FILTER_TYPE type)
+		{
+			float T = 1.0/sample_freq;
+			float wp = cx_bilinear_prewarp(2*CX_PI*cutoff, T);
+
+			float numa[2] = { 0.0, 0.0 };
+			float dena[2] = { wp, 1.0 };
+
+			switch(type) {
+			case FILTER_TYPE_LPF:	numa[0] = wp;	break;
+			case FILTER_TYPE_HPF:	numa[1] = 1.0;	break;
+			default:				assert(false);	break;
+			}
+
+			const CxBilinear<2> d(numa, dena, T);
+
+			return IIR2Coefficients{ static_cast<int16_t>(F2Q15( d.numd[0])),
+									 static_cast<int16_t>(F2Q15( d.numd[1])), 0,
+									 static_cast<int16_t>(F2Q15(-d.dend[1])), 0 };
+		}
 };
 
 
-class IIR2DirectFormI : public IIR1DirectFormI {
+class IIR2DirectFormI : public IIRDirectFormI<2, 14> {
 	public:
 		/**
 		* @brief Constructor
@@ -99,23 +253,12 @@ class IIR2DirectFormI : public IIR1DirectFormI {
 		* @param a1		Q14
 		* @param a2		Q14
 		*/
-		IIR2DirectFormI(int16_t b0 = 0x7FFF, 
+		constexpr IIR2DirectFormI(int16_t b0 = 0x7FFF, 
 						int16_t b1 = 0,
 						int16_t b2 = 0,
 						int16_t a1 = 0,
-						int16_t a2 = 0) : IIR1DirectFormI(b0, b1, a1), b2(b2), a2(a2), ff1(0), fb1(0) { ; }
-
-	protected:
-		// Coefficients
-		int16_t b2;
-		int16_t a2;
-
-		// Delay line buffer
-		int16_t ff1;
-		int32_t fb1;
-
-	private:
-		virtual int32_t convol(int16_t in);
+						int16_t a2 = 0) : IIRDirectFormI(IIR2Coefficients{ b0, b1, b2, a1, a2 }) { ; }
+		constexpr IIR2DirectFormI(const IIR2Coefficients& c) : IIRDirectFormI(c)	{ ; }
 };
 
 class IIRFilter2 : public IIR2DirectFormI {
@@ -124,7 +267,121 @@ class IIRFilter2 : public IIR2DirectFormI {
 			setFreq(cutoff, sample_freq, type, Q);
 		}
 
+		/**
+		* @brief Constructor with the coefficients designed by coefficients(). No design at run time.
+		*/
+		constexpr IIRFilter2(const IIR2Coefficients& c) : IIR2DirectFormI(c)	{ ; }
+
 		void setFreq(float cutoff, float sample_freq, FILTER_TYPE type, float Q);
+
+		static void design(IIR2Coefficients* coef, const float* cutoff, int num, float sample_freq, FILTER_TYPE type, float Q);
+
+		/**
+		* @brief	The same design as setFreq(), evaluated at compile time.
+		*
+		* @param cutoff			Cutoff (or center) frequency (Hz).
+		* @param sample_freq	Sampling frequency (Hz).
+		* @param type			FILTER_TYPE_LPF, FILTER_TYPE_BPF, FILTER_TYPE_HPF or FILTER_TYPE_BEF.
+		* @param Q				Quality factor.
+		*
+		* @return	Q14 coefficients.
+		*
+		* @code
+		*	constexpr IIR2Coefficients c = IIRFilter2::coefficients(600, 8000, FILTER_TYPE_BPF, 0.7071);
+		*	static IIRFilter2 bpf(c);
+		* @endcode
+		*/
+		static constexpr IIR2Coefficients coefficients(float cutoff, float sample_freq, FILTER_TYPE type, float Q)
+		{
+			float T = 1.0/sample_freq;
+			float wp = cx_bilinear_prewarp(2*CX_PI*cutoff, T);
+
+			float numa[3] = { 0.0, 0.0, 0.0 };
+			float dena[3] = { wp*wp, 1/Q*wp, 1.0 };
+
+			switch(type) {
+			case FILTER_TYPE_LPF:	numa[0] = wp*wp;					break;
+			case FILTER_TYPE_BPF:	numa[1] = 1/Q*wp;					break;
+			case FILTER_TYPE_HPF:	numa[2] = 1.0;						break;
+			case FILTER_TYPE_BEF:	numa[0] = wp*wp;	numa[2] = 1.0;	break;
+			default:				assert(false);						break;
+			}
+
+			const CxBilinear<3> d(numa, dena, T);
+
+			return IIR2Coefficients{ static_cast<int16_t>(F2Q14( d.numd[0])),
+									 static_cast<int16_t>(F2Q14( d.numd[1])),
+									 static_cast<int16_t>(F2Q14( d.numd[2])),
+									 static_cast<int16_t>(F2Q14(-d.dend[1])),
+									 static_cast<int16_t>(F2Q14(-d.dend[2])) };
+		}
+};
+
+
+/**
+* @brief	Cascade of the 2nd order sections.
+*
+* @remark	The block is filtered section by section in place, so the delay line
+*			of each section is kept in registers for the whole block.
+*			The Q15 output of each section saturates, so the gains of the sections
+*			have to be scaled to avoid overflow. See IIRBandpass.
+*/
+class IIRCascade {
+	public:
+		IIRCascade(int sections = 1) : sections(sections)	{ assert((0 < sections) && (sections <= IIR_CASCADE_MAX_SECTIONS)); }
+
+		void filter(int16_t* out, const int16_t* in, int num);	// Q15 outputs.
+		void filter(int32_t* out, const int16_t* in, int num);	// Q31 outputs.
+
+		int getSections(void) const		{ return sections; }
+
+		void setCoefficients(int n, const IIR2Coefficients& c)	{ section[n].setCoefficients(c); }
+		IIR2Coefficients getCoefficients(int n) const			{ return section[n].getCoefficients(); }
+
+	protected:
+		int sections;
+		IIRDirectFormI<2, 14, true> section[IIR_CASCADE_MAX_SECTIONS];
+
+	private:
+		void filter_sections(int16_t* out, const int16_t* in, int num, int m);
+};
+
+
+typedef enum {
+	IIR_DESIGN_BUTTERWORTH = 0,
+	IIR_DESIGN_CHEBYSHEV,				// Type I. Equiripple in the passband.
+	IIR_DESIGN_BESSEL,					// Flat group delay. Normalized to -3dB at the band edges.
+	NUMOF_IIR_DESIGN
+} IIR_DESIGN;
+
+/**
+* @brief	Bandpass filter of the cascaded 2nd order sections designed from the
+*			lowpass prototype of the order by the bilinear transformation.
+*
+* @remark	The numerator of each section is scaled so that the peak gain of the
+*			cascade from the input to the output of the section is 0.5
+*			(BANDPASS_HEADROOM in filter.cpp), so the passband is -6 dB. The
+*			overshoot of the high Q sections to the keying doesn't saturate.
+*/
+class IIRBandpass : public IIRCascade {
+	public:
+		/**
+		* @brief Constructor
+		*
+		* @param center			Center frequency in Hz.
+		* @param bandwidth		Bandwidth in Hz. -3dB, or the ripple for IIR_DESIGN_CHEBYSHEV.
+		* @param sample_freq	Sampling frequency in Hz.
+		* @param order			Order of the lowpass prototype. = The number of sections.
+		* @param design
+		* @param ripple			Passband ripple in dB for IIR_DESIGN_CHEBYSHEV.
+		*/
+		IIRBandpass(float center = 600, float bandwidth = 200, float sample_freq = 8000, int order = 4,
+					IIR_DESIGN design = IIR_DESIGN_BUTTERWORTH, float ripple = 0.5) : IIRCascade(order)
+		{
+			setFreq(center, bandwidth, sample_freq, order, design, ripple);
+		}
+
+		void setFreq(float center, float bandwidth, float sample_freq, int order, IIR_DESIGN design, float ripple = 0.5);
 };
 
 #endif /* _FILTER_HPP */
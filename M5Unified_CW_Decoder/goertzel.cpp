@@ -0,0 +1,431 @@
+/*==============================================================================
+* @brief	Host check of the Goertzel classes. goertzel.hpp is header only.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifdef	MODULE_DEBUG
+/*
+*	The variants of the Goertzel are compared with the runtime Goertzel over
+*	randomized frequencies, N, windows and signals.
+*		GoertzelBank:		bit-exact with a Goertzel per bin.
+*		GoertzelN:			bit-exact with a Goertzel of the same N, and the constexpr
+*							coefficient is the same as Goertzel::coefficient().
+*		Goertzel::push():	bit-exact with getMagnitude() for any chunk size.
+*		getComplex():		re^2 + im^2 within the tolerance of getSquaredMagnitude().
+*		CoherentGoertzel:	the frequency offset of a tone off the bin within
+*							OFFSET_TOLERANCE of the bin width.
+*		SlidingGoertzel:	squared magnitude within the tolerance of a Goertzel over
+*							the same window. squaredMagnitude() rounds y0*y1 to Q15, so
+*							the resolution is 4*coef (< 2^17) in Q31 at any level.
+*
+*	e.g.	gcc -O2 -c basic_op.c math_op.c wmops.c
+*			g++ -O2 -DMODULE_DEBUG goertzel.cpp basic_op.o math_op.o wmops.o -o goertzel && ./goertzel
+*/
+#include <cmath>
+#include <cstddef>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "goertzel.hpp"
+
+#define	NUMOF_ROUNDS		2000
+#define	MAX_N				256
+#define	MAX_REPORTS			4			// Mismatches printed per check.
+#define	SLIDING_TOLERANCE	(1L<<18)	// Q31. Twice the resolution of squaredMagnitude().
+#define	SLIDING_RELATIVE	128			// 1/128 of the squared magnitude in addition.
+#define	OFFSET_TOLERANCE	0.05f		// Of the bin width fs/N. The image of the tone leaks COHERENT_GUARD bins away.
+
+static uint64_t rnd_state = 0x3243F6A8885A308DULL;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state<<13;
+	rnd_state ^= rnd_state>>7;
+	rnd_state ^= rnd_state<<17;
+	return (uint32_t)(rnd_state>>16);
+}
+
+static float uniform(float lo, float hi)
+{
+	return lo + (hi - lo)*(rnd() & 0xFFFF)/65536.0f;
+}
+
+/**
+* @brief	Tone of random frequency and amplitude with noise.
+*
+* @param[in] amp_max	Maximum amplitude of the tone. The noise is 1/16 of it.
+*/
+static void signal(int16_t* x, int num, float fs, float amp_max)
+{
+	float f = uniform(100, fs/2 - 100);
+	float a = uniform(0, amp_max);
+	float phase = uniform(0, 2*M_PI);
+
+	for(int n = 0; n < num; n++) {
+		float v = a*sin(2*M_PI*f*n/fs + phase) + a/16*uniform(-1, 1);
+		v = (v < -1)? -1 : (0.99997f < v)? 0.99997f : v;
+		x[n] = F2Q15(v);
+	}
+}
+
+/**
+* @brief	Maximum amplitude of a tone which keeps the state of a Goertzel of
+*			the coefficient below 1/4. The state of a tone at the bin is about
+*			a/(2*sin(w)), and the Goertzel saturates the feedback beyond it at the
+*			bins near DC and fs/2, so it is not a reference there.
+*/
+static float headroom(int16_t coef)
+{
+	return 0.5f*Goertzel::sineOf(coef)/32768;
+}
+
+static int random_N(void)
+{
+	static const int N[] = { 16, 40, 64, 100, 128, 200, MAX_N };
+	return N[rnd() % (sizeof(N)/sizeof(N[0]))];
+}
+
+static int total_fails = 0;
+
+static void report(const char* name, long tests, int fails)
+{
+	printf("%-16s %8ld tests %6d fails\n", name, tests, fails);
+	total_fails += fails;
+}
+
+/*-------------------------------------------------------------------------------
+*	GoertzelBank == Goertzel of each bin.
+-------------------------------------------------------------------------------*/
+#define	BANK_BINS	5
+
+static void checkBank(void)
+{
+	static int16_t in[MAX_N];
+	int fails = 0;
+	long tests = 0;
+
+	for(int round = 0; round < NUMOF_ROUNDS; round++) {
+		const float fs = 8000;
+		int N = random_N();
+		bool k_quantize = (0 != (rnd() & 1));
+		float freq[BANK_BINS];
+		for(int k = 0; k < BANK_BINS; k++) {
+			freq[k] = uniform(100, fs/2 - 100);
+		}
+		GoertzelBank<BANK_BINS> bank(freq, fs, N, k_quantize);
+		signal(in, N, fs, 1.0f);
+
+		int32_t magSq[BANK_BINS];
+		bank.getSquaredMagnitude(magSq, in);
+		for(int k = 0; k < BANK_BINS; k++, tests++) {
+			Goertzel g(freq[k], fs, N, k_quantize);
+			int32_t e = g.getSquaredMagnitude(in);
+			if(magSq[k] != e) {
+				if(fails++ < MAX_REPORTS) {
+					printf("GoertzelBank(N=%d, %.1f Hz): %08x, expected %08x\n", N, freq[k], (unsigned)magSq[k], (unsigned)e);
+				}
+			}
+		}
+	}
+	report("GoertzelBank", tests, fails);
+}
+
+/*-------------------------------------------------------------------------------
+*	GoertzelN<N> == Goertzel of N samples.
+-------------------------------------------------------------------------------*/
+// Evaluated at compile time. 1000 Hz of N = 128 at 8 kHz is k = 16, 2*cos(pi/4) in Q14.
+static constexpr GoertzelN<128> goertzel_1k(1000, 8000);
+static_assert(23170 == GoertzelN<128>::coefficient(1000, 8000), "GoertzelN::coefficient() at compile time");
+
+template <int N>
+static void checkTemplateN(int* fails, long* tests)
+{
+	static int16_t in[N];
+
+	for(int round = 0; round < NUMOF_ROUNDS; round++, (*tests)++) {
+		const float fs = 8000;
+		float f = uniform(0, fs/2);
+		bool k_quantize = (0 != (rnd() & 1));
+		signal(in, N, fs, 1.0f);
+
+		int16_t c = GoertzelN<N>::coefficient(f, fs, k_quantize);
+		int16_t ce = Goertzel::coefficient(f, fs, N, k_quantize);
+		GoertzelN<N> g(f, fs, k_quantize);
+		Goertzel ge(f, fs, N, k_quantize);
+		int32_t magSq = g.getSquaredMagnitude(in);
+		int32_t e = ge.getSquaredMagnitude(in);
+
+		if((c != ce) || (magSq != e)) {
+			if((*fails)++ < MAX_REPORTS) {
+				printf("GoertzelN<%d>(%.3f Hz, %d): coef %d, expected %d, %08x, expected %08x\n",
+					N, f, k_quantize, c, ce, (unsigned)magSq, (unsigned)e);
+			}
+		}
+	}
+}
+
+static void checkTemplate(void)
+{
+	int fails = 0;
+	long tests = 0;
+
+	checkTemplateN<16>(&fails, &tests);
+	checkTemplateN<40>(&fails, &tests);
+	checkTemplateN<100>(&fails, &tests);
+	checkTemplateN<128>(&fails, &tests);
+	checkTemplateN<MAX_N>(&fails, &tests);
+
+	// The object of the constant frequency.
+	Goertzel ge(1000, 8000, 128);
+	int16_t in[128];
+	signal(in, 128, 8000, 1.0f);
+	tests++;
+	if(goertzel_1k.getSquaredMagnitude(in) != ge.getSquaredMagnitude(in)) {
+		fails++;
+		printf("constexpr GoertzelN<128>(1000 Hz): mismatch\n");
+	}
+	report("GoertzelN", tests, fails);
+}
+
+/*-------------------------------------------------------------------------------
+*	Goertzel::push() of random chunks == getMagnitude() of each N samples.
+-------------------------------------------------------------------------------*/
+#define	PUSH_FRAMES		8
+
+struct PushResult {
+	int16_t mag[PUSH_FRAMES];
+	int count;
+};
+
+static void pushCallback(int16_t magnitude, void* user)
+{
+	PushResult* r = static_cast<PushResult*>(user);
+	if(r->count < PUSH_FRAMES) {
+		r->mag[r->count] = magnitude;
+	}
+	r->count++;
+}
+
+static void checkPush(void)
+{
+	static const GOERTZEL_WINDOW windows[] = {
+		GOERTZEL_WINDOW_RECTANGULAR, GOERTZEL_WINDOW_HANN, GOERTZEL_WINDOW_BLACKMAN, GOERTZEL_WINDOW_KAISER,
+	};
+	static int16_t in[PUSH_FRAMES*MAX_N];
+	int fails = 0;
+	long tests = 0;
+
+	for(int round = 0; round < NUMOF_ROUNDS; round++) {
+		const float fs = 8000;
+		int N = random_N();
+		float f = uniform(100, fs/2 - 100);
+		GOERTZEL_WINDOW w = windows[rnd() % (sizeof(windows)/sizeof(windows[0]))];
+		signal(in, PUSH_FRAMES*N, fs, 1.0f);
+
+		Goertzel stream(f, fs, N);
+		Goertzel block(f, fs, N);
+		stream.setWindow(w);
+		block.setWindow(w);
+
+		PushResult r;
+		r.count = 0;
+		stream.setCallback(pushCallback, &r);
+		for(int n = 0; n < PUSH_FRAMES*N; ) {
+			int len = rnd() % (2*N + 1);		// Includes empty and longer than N chunks.
+			if(PUSH_FRAMES*N - n < len) {
+				len = PUSH_FRAMES*N - n;
+			}
+			stream.push(in + n, len);
+			n += len;
+		}
+
+		if(PUSH_FRAMES != r.count) {
+			if(fails++ < MAX_REPORTS) {
+				printf("Goertzel::push(N=%d): %d callbacks, expected %d\n", N, r.count, PUSH_FRAMES);
+			}
+			continue;
+		}
+		for(int i = 0; i < PUSH_FRAMES; i++, tests++) {
+			int16_t e = block.getMagnitude(in + i*N);
+			if(r.mag[i] != e) {
+				if(fails++ < MAX_REPORTS) {
+					printf("Goertzel::push(N=%d, window %d) frame %d: %d, expected %d\n", N, w, i, r.mag[i], e);
+				}
+			}
+		}
+	}
+	report("Goertzel::push", tests, fails);
+}
+
+/*-------------------------------------------------------------------------------
+*	re^2 + im^2 of getComplex() ~= getSquaredMagnitude().
+-------------------------------------------------------------------------------*/
+static void checkComplex(void)
+{
+	static const GOERTZEL_WINDOW windows[] = {
+		GOERTZEL_WINDOW_RECTANGULAR, GOERTZEL_WINDOW_HANN, GOERTZEL_WINDOW_BLACKMAN, GOERTZEL_WINDOW_KAISER,
+	};
+	static int16_t in[MAX_N];
+	int fails = 0;
+	long tests = 0;
+	double max_rel = 0;
+
+	for(int round = 0; round < NUMOF_ROUNDS; round++, tests++) {
+		const float fs = 8000;
+		int N = random_N();
+		float f = uniform(100, fs/2 - 100);
+		bool k_quantize = (0 != (rnd() & 1));
+		Goertzel g(f, fs, N, k_quantize);
+		g.setWindow(windows[rnd() % (sizeof(windows)/sizeof(windows[0]))]);
+		signal(in, N, fs, headroom(Goertzel::coefficient(f, fs, N, k_quantize)));
+
+		int32_t re, im;
+		g.getComplex(&re, &im, in);
+		double zSq = ((double)re*re + (double)im*im)/(1LL<<31);		// Q31
+		int32_t e = g.getSquaredMagnitude(in);
+
+		// Both round y1 to Q15, and squaredMagnitude() y0*y1 as well.
+		double diff = fabs(zSq - e);
+		double tolerance = SLIDING_TOLERANCE + fabs((double)e)/SLIDING_RELATIVE;
+		max_rel = (max_rel < diff/tolerance)? diff/tolerance : max_rel;
+		if(tolerance < diff) {
+			if(fails++ < MAX_REPORTS) {
+				printf("Goertzel::getComplex(N=%d, %.1f Hz): |z|^2 %.0f, expected %08x\n", N, f, zSq, (unsigned)e);
+			}
+		}
+	}
+	report("getComplex", tests, fails);
+	printf("%16s Max. difference %.2f of the tolerance\n", "", max_rel);
+}
+
+/*-------------------------------------------------------------------------------
+*	CoherentGoertzel::getFreqOffset() of a tone off the bin.
+-------------------------------------------------------------------------------*/
+#define	COHERENT_FRAMES		4
+#define	COHERENT_GUARD		4			// Bins from DC and fs/2, where the image of the tone leaks into the bin.
+
+static void checkCoherent(void)
+{
+	static int16_t in[(COHERENT_FRAMES + 2)*MAX_N];
+	int fails = 0;
+	long tests = 0;
+	float max_err = 0;
+
+	for(int round = 0; round < NUMOF_ROUNDS; round++) {
+		const float fs = 8000;
+		int N = random_N();
+		bool k_quantize = (0 != (rnd() & 1));
+		float bin = fs/N;
+		float f = (k_quantize)? (COHERENT_GUARD + rnd() % (N/2 - 2*COHERENT_GUARD + 1))*bin : uniform(COHERENT_GUARD*bin, fs/2 - COHERENT_GUARD*bin);
+		float offset = uniform(-0.4f, 0.4f)*bin;		// Within +/- fs/(2*N).
+		// Above the rounding noise of the feedback, which is about sqrt(N)*2^-16/sin(w) in the state.
+		float a = uniform(0.25f, 1.0f)*headroom(Goertzel::coefficient(f, fs, N, k_quantize));
+		float phase = uniform(0, 2*M_PI);
+		for(int n = 0; n < (COHERENT_FRAMES + 2)*N; n++) {
+			float v = a*sin(2*M_PI*(f + offset)*n/fs + phase) + a/64*uniform(-1, 1);
+			in[n] = F2Q15(v);
+		}
+
+		CoherentGoertzel g(f, fs, N, COHERENT_FRAMES, k_quantize);
+		for(int i = 0; i < COHERENT_FRAMES + 2; i++) {
+			g.getMagnitude(in + i*N);
+		}
+
+		float err = fabs(g.getFreqOffset() - offset)/bin;
+		max_err = (max_err < err)? err : max_err;
+		tests++;
+		if(OFFSET_TOLERANCE < err) {
+			if(fails++ < MAX_REPORTS) {
+				printf("CoherentGoertzel(N=%d, %.1f Hz, %d): offset %.2f Hz, expected %.2f Hz\n", N, f, k_quantize, g.getFreqOffset(), offset);
+			}
+		}
+	}
+	report("CoherentGoertzel", tests, fails);
+	printf("%16s Max. error of the offset %.4f of the bin\n", "", max_err);
+}
+
+/*-------------------------------------------------------------------------------
+*	SlidingGoertzel ~= Goertzel over the last N samples.
+-------------------------------------------------------------------------------*/
+static void checkSliding(void)
+{
+	const int length = (SLIDING_GOERTZEL_RESYNC + 2)*MAX_N;		// Beyond a recomputation.
+	static int16_t in[(SLIDING_GOERTZEL_RESYNC + 2)*MAX_N];
+	int fails = 0;
+	long tests = 0;
+	double max_rel = 0;
+
+	for(int round = 0; round < NUMOF_ROUNDS/10; round++) {
+		const float fs = 8000;
+		int N = random_N();
+		int hop = 1 + rnd() % N;
+		float f = uniform(100, fs/2 - 100);
+		signal(in, length, fs, headroom(Goertzel::coefficient(f, fs, N)));
+
+		SlidingGoertzel sliding(f, fs, N, hop);
+		Goertzel block(f, fs, N);
+
+		for(int n = 0; n + hop <= length; n += hop) {
+			int32_t magSq = sliding.getSquaredMagnitude(in + n);
+			if(n + hop < N) {
+				continue;
+			}
+			int32_t e = block.getSquaredMagnitude(in + n + hop - N);
+			double diff = fabs((double)magSq - e);
+			double tolerance = SLIDING_TOLERANCE + fabs((double)e)/SLIDING_RELATIVE;
+			max_rel = (max_rel < diff/tolerance)? diff/tolerance : max_rel;
+			tests++;
+			if(tolerance < diff) {
+				if(fails++ < MAX_REPORTS) {
+					printf("SlidingGoertzel(N=%d, hop=%d) at %d: %08x, expected %08x\n", N, hop, n + hop, (unsigned)magSq, (unsigned)e);
+				}
+			}
+		}
+	}
+	report("SlidingGoertzel", tests, fails);
+	printf("%16s Max. difference %.2f of the tolerance\n", "", max_rel);
+}
+
+
+int main(void)
+{
+	checkBank();
+	checkTemplate();
+	checkPush();
+	checkComplex();
+	checkCoherent();
+	checkSliding();
+
+	printf("%s: %d fails\n", (0 == total_fails)? "PASS" : "FAIL", total_fails);
+
+	return (0 == total_fails)? 0 : 1;
+}
+#endif	/* MODULE_DEBUG */
+/*==============================================================================
+*	End
+*===============================================================================*/
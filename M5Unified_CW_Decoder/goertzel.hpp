@@ -35,10 +35,35 @@
 #define	_GOERTZEL_HPP
 
 #include "basic_op.h"
+#include "math_op.h"
 #include "f2q.h"
+#include "cxmath.hpp"
+
+//******** Configurations ********************************************
+//--------	Calc magnitude with floating-point sqrt(). ---------------
+// #define	GOERTZEL_FLOAT_MAGNITUDE
+//--------------------------------------------------------------------
+
+/**
+*	Window functions of Goertzel.
+*/
+typedef enum {
+	GOERTZEL_WINDOW_RECTANGULAR = 0,
+	GOERTZEL_WINDOW_HANN,				// Sidelobe -31 dB.
+	GOERTZEL_WINDOW_BLACKMAN,			// Sidelobe -58 dB.
+	GOERTZEL_WINDOW_KAISER,				// Sidelobe depends on beta. -45 dB at beta = 6.
+} GOERTZEL_WINDOW;
 
 class Goertzel {
 public:
+	/**
+	* @brief	Called by push() every N samples.
+	*
+	* @param[in] magnitude		Magnitude. Q15 format.
+	* @param[in] user			The pointer given to setCallback().
+	*/
+	typedef void (*MagnitudeCallback)(int16_t magnitude, void* user);
+
 	/**
 	* @brief Constructor
 	*
@@ -46,26 +71,197 @@ public:
 	* @param[in] sampling_freq		Sampling frequency (Hz).
 	* @param[in] N								The number of samples.
 	*/
-	Goertzel(float freq = 1000, float sampling_freq = 8000, int N = 128, bool k_quantize = true) {
+	Goertzel(float freq = 1000, float sampling_freq = 8000, int N = 128, bool k_quantize = true)
+		: N(0), window_type(GOERTZEL_WINDOW_RECTANGULAR), kaiser_beta(0), window(nullptr), callback(nullptr), user(nullptr) {
 		setFreq(freq, sampling_freq, N, k_quantize);
 	}
 
+	~Goertzel() {
+		delete[] window;
+	}
+
+	Goertzel(const Goertzel&) = delete;
+	Goertzel& operator=(const Goertzel&) = delete;
+
 	/**
 	* @brief Calc and set coefficients.
 	*
 	* @param[in] freq							Target frequency (Hz).
 	* @param[in] sampling_freq		Sampling frequency (Hz).
 	* @param[in] N								The number of samples.
+	*
+	* @remark	The window table is rebuilt only when N is changed.
 	*/
 	void setFreq(float freq, float sampling_freq, int num, bool k_quantize = true)
 	{
+		bool resize = (num != N) || ((GOERTZEL_WINDOW_RECTANGULAR != window_type) && (nullptr == window));
 		N = num;
 
+		coef = coefficient(freq, sampling_freq, N, k_quantize);
+		sine = sineOf(coef);
+
+		att = F2Q15(1.0f/N);
+
+		y[0] = y[1] = 0;
+		count = 0;
+
+		if(resize) {
+			setWindow(window_type, kaiser_beta);
+		}
+	}
+
+	/**
+	* @brief	Set the coefficient only. N, the window and the state are kept,
+	*			so the frequency can be retuned while streaming.
+	*
+	* @param[in] c		Q14 coefficient given by coefficient().
+	*/
+	void setCoef(int16_t c)		{ coef = c;	sine = sineOf(c); }
+
+	/**
+	* @brief	Set the window function. The Q15 table of N samples is generated
+	*			here, and applied in the feedback instead of the attenuation 1/N.
+	*
+	* @param[in] type		Window function.
+	* @param[in] beta		Beta of the Kaiser window.
+	*
+	* @remark	The table is normalized by sum(w), so the magnitude of a tone at
+	*			the bin frequency is the same as the rectangular window.
+	*/
+	void setWindow(GOERTZEL_WINDOW type, float beta = 6.0f)
+	{
+		delete[] window;
+		window = nullptr;
+		window_type = type;
+		kaiser_beta = beta;
+
+		if(GOERTZEL_WINDOW_RECTANGULAR == type) {
+			return;
+		}
+
+		float* w = new float[N];
+		float sum = 0;
+		for(int n = 0; n < N; n++) {
+			float phase = 2*M_PI*n/N;		// Periodic (DFT-even) window.
+
+			switch(type) {
+			case GOERTZEL_WINDOW_HANN:
+				w[n] = 0.5f - 0.5f*cos(phase);
+				break;
+			case GOERTZEL_WINDOW_BLACKMAN:
+				w[n] = 0.42f - 0.5f*cos(phase) + 0.08f*cos(2*phase);
+				break;
+			case GOERTZEL_WINDOW_KAISER:
+			default:
+				{
+					float r = 2.0f*n/N - 1;
+					w[n] = besselI0(beta*sqrt(1 - r*r))/besselI0(beta);
+				}
+				break;
+			}
+			sum += w[n];
+		}
+
+		int16_t* table = new int16_t[N];
+		for(int n = 0; n < N; n++) {
+			table[n] = F2Q15(w[n]/sum);
+		}
+		delete[] w;
+
+		window = table;
+	}
+
+	/**
+	* @brief	Goertzel coefficient.
+	*
+	* @return	Q14 coefficient. = 2*cos(2*pi*k/N)
+	*/
+	static int16_t coefficient(float freq, float sampling_freq, int N, bool k_quantize = true)
+	{
 		float k = (k_quantize)?  static_cast<int>(N*freq/sampling_freq + 0.5) : N*freq/sampling_freq;
 
-		coef = F2Q14(2*cos((2*M_PI*k)/N));
+		return F2Q14(2*cos((2*M_PI*k)/N));
+	}
 
-		att = F2Q15(1.0f/N);
+	/**
+	* @brief	Squared magnitude from the last two outputs of the feedback.
+	*
+	* @return	Q31 format. = y0^2 + y1^2 - (y0*y1)*coef.
+	*/
+	static int32_t squaredMagnitude(int32_t y_0, int32_t y_1, int16_t coef)
+	{
+		int16_t y0 = round_fx(y_0);
+		int16_t y1 = round_fx(y_1);
+
+		int32_t magSq = mult(y0, y1);
+		magSq = L_shl(L_mult(magSq, coef), 15 - 14);
+		magSq = L_negate(magSq);
+		magSq = L_mac(magSq, y1, y1);
+		magSq = L_mac(magSq, y0, y0);
+
+		return magSq;
+	}
+
+	/**
+	* @brief	Complex bin value from the last two outputs of the feedback.
+	*
+	* @param[out] re		Real part. Q31 format. = y0 - y1*cos(w)
+	* @param[out] im		Imaginary part. Q31 format. = y1*sin(w)
+	* @param[in] sine		sin(w) in Q15 given by sineOf(coef).
+	*
+	* @remark	re + j*im = exp(j*w*(N - 1))*DFT(w) of the N samples, and
+	*			re^2 + im^2 = squaredMagnitude(y0, y1, coef).
+	*/
+	static void complexBin(int32_t* re, int32_t* im, int32_t y_0, int32_t y_1, int16_t coef, int16_t sine)
+	{
+		int16_t y1 = round_fx(y_1);
+
+		*re = L_sub(y_0, L_mult(y1, coef));		// Q14 2*cos(w) = Q15 cos(w)
+		*im = L_mult(y1, sine);
+	}
+
+	/**
+	* @brief	sin(w) in Q15 from the coefficient. 0 <= w <= pi.
+	*/
+	static int16_t sineOf(int16_t coef)
+	{
+		return sqrt_l(L_msu(INT32_MAX, coef, coef));
+	}
+
+	/**
+	* @brief	Magnitude from the squared magnitude.
+	*
+	* @return	Q15 format. = sqrt(magSq).
+	*/
+	static int16_t magnitude(int32_t magSq)
+	{
+		magSq = L_max(magSq, 1);
+#ifdef	GOERTZEL_FLOAT_MAGNITUDE
+		float magf = sqrt(magSq/((1LL<<31)*1.0f));
+		return F2Q15(magf);
+#else
+		return sqrt_l(magSq);
+#endif
+	}
+
+	/**
+	* @brief	Base 2 logarithm of the magnitude from the squared magnitude.
+	*
+	* @return	Q10 format. = log2(sqrt(magSq)), -15.5 <= return value <= 0.
+	*/
+	static int16_t log2Magnitude(int32_t magSq)
+	{
+		return shr_r(log2_l(L_max(magSq, 1)), 1);
+	}
+
+	/**
+	* @brief	Magnitude in decibels from the squared magnitude.
+	*
+	* @return	Q7 format. = 20*log10(sqrt(magSq)) = 10*log10(2)*log2(magSq) dB.
+	*/
+	static int16_t dbMagnitude(int32_t magSq)
+	{
+		return mult_r(log2_l(L_max(magSq, 1)), F2Q15(10*0.30103f/8));		// Q10 -> Q7
 	}
 
 	/**
@@ -80,16 +276,21 @@ public:
 	{
 		compute(in);
 
-		int16_t y0 = round_fx(y[0]);
-		int16_t y1 = round_fx(y[1]);
+		return squaredMagnitude(y[0], y[1], coef);
+	}
 
-		int32_t magSq = mult(y0, y1);
-		magSq = L_shl(L_mult(magSq, coef), 15 - 14);
-		magSq = L_negate(magSq);
-		magSq = L_mac(magSq, y1, y1);
-		magSq = L_mac(magSq, y0, y0);
+	/**
+	* @brief	Calc complex bin value.
+	*
+	* @param[out] re		Real part. Q31 format.
+	* @param[out] im		Imaginary part. Q31 format.
+	* @param[in] in			The pointer to input samples. in[N].
+	*/
+	void getComplex(int32_t* re, int32_t* im, const int16_t* in)
+	{
+		compute(in);
 
-		return magSq;
+		complexBin(re, im, y[0], y[1], coef, sine);
 	}
 
 	/**
@@ -102,17 +303,103 @@ public:
 	*/
 	int16_t getMagnitude(const int16_t* in /* , int N */)
 	{
-		int32_t magSq = L_max(getSquaredMagnitude(in), 1);
-		float magf = sqrt(magSq/((1LL<<31)*1.0f));
-		return F2Q15(magf);
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		return magnitude(getSquaredMagnitude(in));
+	}
+
+	/**
+	* @brief	Calc base 2 logarithm of the magnitude.
+	*
+	* @param[in] in			The pointer to inputsamples. in[N].
+	*
+	* @return		Q10 format. = log2(magnitude).
+	*/
+	int16_t getLog2Magnitude(const int16_t* in)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		return log2Magnitude(getSquaredMagnitude(in));
+	}
+
+	/**
+	* @brief	Calc magnitude in decibels.
+	*
+	* @param[in] in			The pointer to inputsamples. in[N].
+	*
+	* @return		Q7 format. = 20*log10(magnitude) dB. 0 dB is the full scale.
+	*/
+	int16_t getDbMagnitude(const int16_t* in)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		return dbMagnitude(getSquaredMagnitude(in));
+	}
+
+	/**
+	* @brief	Set the callback of push().
+	*
+	* @param[in] cb			Callback. nullptr to disable.
+	* @param[in] user_ptr	Passed to the callback as is.
+	*/
+	void setCallback(MagnitudeCallback cb, void* user_ptr = nullptr)
+	{
+		callback = cb;
+		user = user_ptr;
+	}
+
+	/**
+	* @brief	Streaming input. Samples of any chunk size are accumulated, and the
+	*			callback is called with the magnitude every N samples.
+	*
+	* @param[in] in			The pointer to input samples. in[num].
+	* @param[in] num		The number of samples.
+	*
+	* @remark	The feedback state is kept across calls. Don't mix with
+	*			getMagnitude(), which starts from the reset state.
+	*/
+	void push(const int16_t* in, size_t num)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		while(0 < num) {
+			int len = N - count;
+			if(num < (size_t)len) {
+				len = num;
+			}
+
+			feed(in, len);
+			in += len;
+			num -= len;
+			count += len;
+
+			if(N <= count) {
+				int16_t mag = magnitude(squaredMagnitude(y[0], y[1], coef));
+				y[0] = y[1] = 0;
+				count = 0;
+
+				if(nullptr != callback) {
+					callback(mag, user);
+				}
+			}
+		}
 	}
 
 private:
 	int N;
 	int32_t y[2];
+	int count;			// Samples pushed into y[].
 
 	int16_t coef;		// Q14
+	int16_t sine;		// Q15. sin(w) of the coefficient.
 	int16_t	att;		// Q15
+
+	GOERTZEL_WINDOW window_type;
+	float kaiser_beta;
+	const int16_t* window;		// Q15. window[N]. nullptr for the rectangular window.
+
+	MagnitudeCallback callback;
+	void* user;
 	
 	/**
 	* @brief Goertzel algorithm feedback calc.
@@ -124,15 +411,610 @@ private:
 	void compute(const int16_t* in)
 	{
 		y[0] = y[1] = 0;
+		count = 0;
+
+		feed(in, N);
+	}
+
+	/**
+	* @brief Goertzel algorithm feedback of num samples from the current state.
+	*/
+	void feed(const int16_t* in, int num)
+	{
+		if(nullptr == window) {
+			for (int i = 0 ; i < num; i++) {
+				int32_t acc;
+				acc = L_shl(L_mult(round_fx(y[0]), coef), 15 - 14);
+				acc = L_sub(acc, y[1]);
+				y[1] = y[0];
+				y[0] = L_mac(acc, att, *in++);
+			}
+		} else {
+			const int16_t* w = window + count;
+
+			for (int i = 0 ; i < num; i++) {
+				int32_t acc;
+				acc = L_shl(L_mult(round_fx(y[0]), coef), 15 - 14);
+				acc = L_sub(acc, y[1]);
+				y[1] = y[0];
+				y[0] = L_mac(acc, *w++, *in++);		// The window replaces att.
+			}
+		}
+	}
+
+	/**
+	* @brief	Modified Bessel function of the first kind, order 0.
+	*/
+	static float besselI0(float x)
+	{
+		float sum = 1;
+		float term = 1;
+		for(int k = 1; k < 32; k++) {
+			term *= (x/(2*k))*(x/(2*k));
+			sum += term;
+			if(term < sum*1e-7f) {
+				break;
+			}
+		}
+		return sum;
+	}
+};
+
+
+/**
+* @brief	Goertzel with the number of samples fixed at compile time. The loop
+*			bound is a constant and the state is kept in local variables, so the
+*			compiler can unroll the loop and keep the state in registers.
+*			Bit-exact with a Goertzel of the same N and coefficient.
+*
+* @tparam N		The number of samples.
+*
+* @remark	The constructor is constexpr, so a static object with the constant
+*			frequencies is initialized at compile time. Use Goertzel for the
+*			window and push().
+*/
+template <int N>
+class GoertzelN {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	*/
+	constexpr GoertzelN(float freq = 1000, float sampling_freq = 8000, bool k_quantize = true)
+		: coef(coefficient(freq, sampling_freq, k_quantize)) { }
+
+	/**
+	* @brief	Calc and set the coefficient at run time.
+	*/
+	void setFreq(float freq, float sampling_freq, bool k_quantize = true)
+	{
+		coef = Goertzel::coefficient(freq, sampling_freq, N, k_quantize);
+	}
+
+	/**
+	* @brief	Set the coefficient only.
+	*
+	* @param[in] c		Q14 coefficient given by coefficient().
+	*/
+	void setCoef(int16_t c)		{ coef = c; }
+
+	/**
+	* @brief	Goertzel coefficient at compile time. Same as Goertzel::coefficient().
+	*
+	* @return	Q14 coefficient. = 2*cos(2*pi*k/N)
+	*/
+	static constexpr int16_t coefficient(float freq, float sampling_freq, bool k_quantize = true)
+	{
+		float k = (k_quantize)?  static_cast<int>(N*freq/sampling_freq + 0.5) : N*freq/sampling_freq;
+
+		return F2Q14(2*cx_cos((2*CX_PI*k)/N));
+	}
+
+	/**
+	* @brief	Calc squared magnitude.
+	*
+	* @param[in] in			The pointer to input samples. in[N].
+	*
+	* @return	Squared magnitude. Q31 format.
+	*/
+	int32_t getSquaredMagnitude(const int16_t* in) const
+	{
+		int32_t y0 = 0;
+		int32_t y1 = 0;
+
+		for(int i = 0; i < N; i++) {
+			int32_t acc;
+			acc = L_shl(L_mult(round_fx(y0), coef), 15 - 14);
+			acc = L_sub(acc, y1);
+			y1 = y0;
+			y0 = L_mac(acc, att, in[i]);
+		}
+
+		return Goertzel::squaredMagnitude(y0, y1, coef);
+	}
+
+	/**
+	* @brief	Calc magnitude.
+	*
+	* @param[in] in			The pointer to input samples. in[N].
+	*
+	* @return	Magnitude. Q15 format.
+	*/
+	int16_t getMagnitude(const int16_t* in) const
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		return Goertzel::magnitude(getSquaredMagnitude(in));
+	}
+
+private:
+	static constexpr int16_t att = F2Q15(1.0f/N);		// Q15
+
+	int16_t coef;		// Q14
+};
+
+
+/**
+* @brief	K bins of the Goertzel algorithm computed in one pass over the samples.
+*			Each bin is bit-exact with a Goertzel of the same frequency.
+*
+* @tparam K		The number of bins.
+*/
+template <int K>
+class GoertzelBank {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Target frequencies (Hz). freq[K].
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples.
+	*/
+	GoertzelBank(const float* freq, float sampling_freq = 8000, int N = 128, bool k_quantize = true) {
+		setFreq(freq, sampling_freq, N, k_quantize);
+	}
+
+	/**
+	* @brief Constructor. The coefficients are set by setCoef() later.
+	*
+	* @param[in] N					The number of samples.
+	*/
+	GoertzelBank(int N = 128) : N(N), att(F2Q15(1.0f/N)) {
+		for(int k = 0; k < K; k++) {
+			coef[k] = 0;
+		}
+	}
+
+	/**
+	* @brief Calc and set coefficients of all the bins.
+	*
+	* @param[in] freq				Target frequencies (Hz). freq[K].
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples.
+	*/
+	void setFreq(const float* freq, float sampling_freq, int num, bool k_quantize = true)
+	{
+		N = num;
+		att = F2Q15(1.0f/N);
+
+		for(int k = 0; k < K; k++) {
+			coef[k] = Goertzel::coefficient(freq[k], sampling_freq, N, k_quantize);
+		}
+	}
+
+	/**
+	* @brief Calc and set the coefficient of a bin.
+	*
+	* @param[in] bin				Bin index. 0 <= bin < K.
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	*/
+	void setFreq(int bin, float freq, float sampling_freq, bool k_quantize = true)
+	{
+		coef[bin] = Goertzel::coefficient(freq, sampling_freq, N, k_quantize);
+	}
+
+	/**
+	* @brief Set the coefficient of a bin.
+	*
+	* @param[in] bin		Bin index. 0 <= bin < K.
+	* @param[in] c			Q14 coefficient given by Goertzel::coefficient().
+	*/
+	void setCoef(int bin, int16_t c)	{ coef[bin] = c; }
+
+	/**
+	* @brief	Calc squared magnitudes of all the bins.
+	*
+	* @param[out] magSq		Squared magnitudes. Q31 format. magSq[K].
+	* @param[in] in			The pointer to input samples. in[N].
+	*/
+	void getSquaredMagnitude(int32_t* magSq, const int16_t* in)
+	{
+		compute(in);
+
+		for(int k = 0; k < K; k++) {
+			magSq[k] = Goertzel::squaredMagnitude(y0[k], y1[k], coef[k]);
+		}
+	}
+
+	/**
+	* @brief	Calc magnitudes of all the bins.
+	*
+	* @param[out] mag		Magnitudes. Q15 format. mag[K].
+	* @param[in] in			The pointer to input samples. in[N].
+	*/
+	void getMagnitude(int16_t* mag, const int16_t* in)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		int32_t magSq[K];
+		getSquaredMagnitude(magSq, in);
+
+		for(int k = 0; k < K; k++) {
+			mag[k] = Goertzel::magnitude(magSq[k]);
+		}
+	}
+
+private:
+	int N;
+	int16_t att;		// Q15
+
+	// Structure of arrays, so that the inner loop over the bins vectorizes.
+	int32_t y0[K];
+	int32_t y1[K];
+	int16_t coef[K];	// Q14
+
+	/**
+	* @brief Goertzel algorithm feedback calc of all the bins.
+	*
+	* @param[in] in			The pointer to input data. in[N]
+	*
+	* @remark	The input term L_mult(att, in) is common to the bins and computed
+	*			once per sample. L_mac(acc, att, in) = L_add(acc, L_mult(att, in)).
+	*/
+	void compute(const int16_t* in)
+	{
+		for(int k = 0; k < K; k++) {
+			y0[k] = y1[k] = 0;
+		}
+
+		for(int i = 0; i < N; i++) {
+			int32_t x = L_mult(att, *in++);
+
+			for(int k = 0; k < K; k++) {
+				int32_t acc;
+				acc = L_shl(L_mult(round_fx(y0[k]), coef[k]), 15 - 14);
+				acc = L_sub(acc, y1[k]);
+				y1[k] = y0[k];
+				y0[k] = L_add(acc, x);
+			}
+		}
+	}
+};
+
+#define	SLIDING_GOERTZEL_RESYNC		16		// Windows between the recomputations of the resonator.
+
+/**
+* @brief	Sliding Goertzel. The window of N samples is advanced by hop samples,
+*			and the magnitude is updated every hop samples.
+*
+* @remark	One resonator runs over all samples, and the sample leaving the window
+*			is removed from its state by the impulse response h[] of the resonator:
+*				v[n] = coef*v[n - 1] - v[n - 2] + x[n]/(2*N)
+*				v[n] -= h[N]*x[n - N]/(2*N),  v[n - 1] -= h[N - 1]*x[n - N]/(2*N)
+*			So the state is the Goertzel of the last N samples at every sample, for
+*			any k, with one resonator update and two removals per sample for any
+*			hop. h[] is of the quantized coef, so the removal is exact except the
+*			rounding. The state is a half of the Goertzel for the headroom, so the
+*			loud tones don't saturate it. The feedback is in 32 bit by L_mls(),
+*			and as the poles on the unit circle don't decay the rounding errors,
+*			the state is recomputed from the delay line every
+*			SLIDING_GOERTZEL_RESYNC windows, after a saturation and by setCoef().
+*			The magnitude is within a few LSB of a Goertzel over the same window.
+*/
+class SlidingGoertzel {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples of the window.
+	* @param[in] hop				The number of samples the window is advanced by.
+	*/
+	SlidingGoertzel(float freq = 1000, float sampling_freq = 8000, int N = 128, int hop = 32, bool k_quantize = true)
+		: N(0), delay(nullptr) {
+		setFreq(freq, sampling_freq, N, hop, k_quantize);
+	}
+
+	~SlidingGoertzel() {
+		delete[] delay;
+	}
+
+	SlidingGoertzel(const SlidingGoertzel&) = delete;
+	SlidingGoertzel& operator=(const SlidingGoertzel&) = delete;
+
+	/**
+	* @brief Calc and set coefficients, and restart the window.
+	*
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples of the window.
+	* @param[in] hop				The number of samples the window is advanced by.
+	*/
+	void setFreq(float freq, float sampling_freq, int num, int hop, bool k_quantize = true)
+	{
+		if(num != N) {
+			delete[] delay;
+			delay = new int16_t[num];
+		}
+		N = num;
+		H = (hop < 1)? 1 : hop;
+
+		coef = Goertzel::coefficient(freq, sampling_freq, N, k_quantize);
+		att = F2Q15(1.0f/N);
+		setRemoval();
+
+		for(int n = 0; n < N; n++) {
+			delay[n] = 0;
+		}
+		pos = 0;
+		filled = 0;
+		elapsed = 0;
+		y0 = y1 = 0;
+		magSq = 0;
+	}
+
+	/**
+	* @brief	Set the coefficient only. The window is kept, and the resonator is
+	*			recomputed over it with the new coefficient.
+	*
+	* @param[in] c		Q14 coefficient given by Goertzel::coefficient().
+	*/
+	void setCoef(int16_t c)		{ coef = c;	setRemoval();	resync(); }
 
-		for (int i = 0 ; i < N; i++) {
+	/**
+	* @brief	Hop size.
+	*/
+	int getHop(void) const	{ return H; }
+
+	/**
+	* @brief	Push hop samples and calc squared magnitude of the latest window.
+	*
+	* @param[in] in			The pointer to input samples. in[hop].
+	*
+	* @return	Squared magnitude. Q31 format. 0 until the first window is filled.
+	*/
+	int32_t getSquaredMagnitude(const int16_t* in)
+	{
+		bool saturated = false;
+
+		for(int i = 0; i < H; i++) {
 			int32_t acc;
-			acc = L_shl(L_mult(round_fx(y[0]), coef), 15 - 14);
-			acc = L_sub(acc, y[1]);
-			y[1] = y[0];
-			y[0] = L_mac(acc, att, *in++);
+			acc = L_shl(L_mls(y0, coef), 15 - 14);
+			saturated |= (INT32_MAX == acc) || (INT32_MIN == acc);
+			acc = L_sub(acc, y1);
+			y1 = y0;
+			y0 = L_add(acc, L_shr(L_mult(att, *in), 1));
+			saturated |= (INT32_MAX == y0) || (INT32_MIN == y0);
+
+			int16_t old = delay[pos];			// The oldest sample leaves the window.
+			y0 = L_sub(y0, L_mls(remove[0], old));
+			y1 = L_sub(y1, L_mls(remove[1], old));
+			delay[pos] = *in++;
+			pos = (N - 1 <= pos)? 0 : pos + 1;
+		}
+
+		filled = (N - H <= filled)? N : filled + H;
+		elapsed += H;
+		if(saturated || (SLIDING_GOERTZEL_RESYNC*N <= elapsed)) {
+			resync();
 		}
+
+		if(N <= filled) {
+			// The Goertzel of full scale while the sum of the squared magnitude can't saturate.
+			const int32_t quarter = 0x20000000L;
+			if((-quarter < y0) && (y0 < quarter) && (-quarter < y1) && (y1 < quarter)) {
+				magSq = Goertzel::squaredMagnitude(L_shl(y0, 1), L_shl(y1, 1), coef);
+			} else {
+				magSq = L_shl(Goertzel::squaredMagnitude(y0, y1, coef), 2);
+			}
+		}
+		return magSq;
 	}
+
+	/**
+	* @brief	Push hop samples and calc magnitude of the latest window.
+	*
+	* @param[in] in			The pointer to input samples. in[hop].
+	*
+	* @return	Magnitude. Q15 format.
+	*/
+	int16_t getMagnitude(const int16_t* in)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		return Goertzel::magnitude(getSquaredMagnitude(in));
+	}
+
+private:
+	int N;
+	int H;
+	int16_t* delay;		// The last N samples. delay[pos] is the oldest.
+	int pos;
+	int filled;			// Samples in the window, up to N.
+	int elapsed;		// Samples since the last recomputation.
+	int32_t y0, y1;		// Half of the Goertzel for the headroom of the samples in and out.
+	int32_t magSq;		// Squared magnitude of the latest window.
+
+	int16_t coef;		// Q14
+	int16_t att;		// Q15
+	int32_t remove[2];	// = h[N]*att/2, h[N - 1]*att/2 in Q31, so that L_mls(remove, x) is the contribution of x.
+
+	/**
+	* @brief	Impulse response of the resonator at N and N - 1 for the removal.
+	*/
+	void setRemoval(void)
+	{
+		double c = coef/16384.0;
+		double h0 = 1, h1 = 0;			// h[n], h[n - 1]
+		for(int n = 0; n < N; n++) {
+			double h = c*h0 - h1;
+			h1 = h0;
+			h0 = h;
+		}
+		for(int i = 0; i < 2; i++) {
+			double g = ((0 == i)? h0 : h1)*att*32768.0;
+			remove[i] = (g < INT32_MIN)? INT32_MIN : (INT32_MAX < g)? INT32_MAX : static_cast<int32_t>(g + ((g < 0)? -0.5 : 0.5));
+		}
+	}
+
+	/**
+	* @brief	Recompute the resonator over the delay line, from the oldest sample.
+	*/
+	void resync(void)
+	{
+		y0 = y1 = 0;
+		for(int n = 0; n < N; n++) {
+			int32_t acc;
+			acc = L_shl(L_mls(y0, coef), 15 - 14);
+			acc = L_sub(acc, y1);
+			y1 = y0;
+			y0 = L_add(acc, L_shr(L_mult(att, delay[(pos + n < N)? pos + n : pos + n - N]), 1));
+		}
+		elapsed = 0;
+	}
+};
+
+#define	COHERENT_GOERTZEL_MAX_FRAMES	16
+
+/**
+* @brief	Goertzel with the complex bin values of the consecutive frames.
+*			The magnitude is the coherent average of the last frames, and the
+*			frequency offset from the bin is estimated by the phase difference.
+*
+* @remark	A tone at the bin frequency w advances the phase by w*N per frame.
+*			The older frames are rotated by exp(j*w*N) per frame to the latest
+*			one and summed, so the tone adds up in amplitude and the noise in
+*			power, i.e. 10*log10(frames) dB better SNR than a frame of N samples.
+*			The phase advance beyond w*N is (w0 - w)*N, which gives the offset
+*			of the tone w0 within +/- fs/(2*N).
+*/
+class CoherentGoertzel {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Target frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples of a frame.
+	* @param[in] frames				The number of frames averaged. <= COHERENT_GOERTZEL_MAX_FRAMES.
+	*/
+	CoherentGoertzel(float freq = 1000, float sampling_freq = 8000, int N = 128, int frames = 4, bool k_quantize = true) {
+		setFreq(freq, sampling_freq, N, frames, k_quantize);
+	}
+
+	/**
+	* @brief Calc and set coefficients, and clear the frames.
+	*/
+	void setFreq(float freq, float sampling_freq, int num, int frames, bool k_quantize = true)
+	{
+		goertzel.setFreq(freq, sampling_freq, num, k_quantize);
+
+		F = (frames < 1)? 1 : (COHERENT_GOERTZEL_MAX_FRAMES < frames)? COHERENT_GOERTZEL_MAX_FRAMES : frames;
+		inv = (1 == F)? INT16_MAX : F2Q15(1.0f/F);
+
+		// Phase advance per frame. = w*N = 2*pi*k.
+		float k = (k_quantize)?  static_cast<int>(num*freq/sampling_freq + 0.5) : num*freq/sampling_freq;
+		float c = cos(2*M_PI*k);
+		float s = sin(2*M_PI*k);
+		rot_re = (INT16_MAX < F2Q15(c))? INT16_MAX : F2Q15(c);		// cos() within 2^-16 of 1 rounds to 32768.
+		rot_im = (INT16_MAX < F2Q15(s))? INT16_MAX : F2Q15(s);
+
+		half_bin = sampling_freq/(2*num);
+
+		for(int i = 0; i < F; i++) {
+			hist_re[i] = hist_im[i] = 0;
+		}
+		index = 0;
+		prev_re = prev_im = 0;
+		phase_diff = 0;
+	}
+
+	/**
+	* @brief	Push a frame, and calc the magnitude of the coherent average.
+	*
+	* @param[in] in			The pointer to input samples. in[N].
+	*
+	* @return	Magnitude. Q15 format.
+	*/
+	int16_t getMagnitude(const int16_t* in)
+	{
+		WMOPS_STAGE_SCOPE(WMOPS_STAGE_GOERTZEL);
+
+		int32_t re, im;
+		goertzel.getComplex(&re, &im, in);
+		int16_t zr = round_fx(re);
+		int16_t zi = round_fx(im);
+
+		// z*conj(prev)*conj(rot) = |z||prev|*exp(j*(w0 - w)*N)
+		int32_t pr = L_mac(L_mult(zr, prev_re), zi, prev_im);
+		int32_t pi = L_msu(L_mult(zi, prev_re), zr, prev_im);
+		int16_t sh = norm_l(L_max(L_abs(pr), L_abs(pi)));
+		int16_t dr = round_fx(L_shl(pr, sh));
+		int16_t di = round_fx(L_shl(pi, sh));
+		phase_diff = atan2_s(round_fx(L_msu(L_mult(di, rot_re), dr, rot_im)),
+							 round_fx(L_mac(L_mult(dr, rot_re), di, rot_im)));
+		prev_re = zr;
+		prev_im = zi;
+
+		// Coherent average by Horner's method from the oldest frame.
+		hist_re[index] = mult_r(zr, inv);
+		hist_im[index] = mult_r(zi, inv);
+		index = (F - 1 <= index)? 0 : index + 1;
+
+		int16_t sr = 0;
+		int16_t si = 0;
+		for(int i = 0, j = index; i < F; i++) {
+			int16_t tr = round_fx(L_msu(L_mult(sr, rot_re), si, rot_im));
+			int16_t ti = round_fx(L_mac(L_mult(sr, rot_im), si, rot_re));
+			sr = add(tr, hist_re[j]);
+			si = add(ti, hist_im[j]);
+			j = (F - 1 <= j)? 0 : j + 1;
+		}
+
+		return Goertzel::magnitude(L_mac(L_mult(sr, sr), si, si));
+	}
+
+	/**
+	* @brief	Phase difference of the last 2 frames beyond the bin frequency.
+	*
+	* @return	Q15 in units of pi. = (w0 - w)*N/pi.
+	*/
+	int16_t getPhaseDiff(void) const	{ return phase_diff; }
+
+	/**
+	* @brief	Frequency offset of the tone from the bin (Hz). = w0 - w.
+	*/
+	float getFreqOffset(void) const		{ return phase_diff*half_bin/32768; }
+
+private:
+	Goertzel goertzel;
+
+	int F;				// The number of frames.
+	int index;			// The oldest frame in hist[].
+	int16_t inv;		// Q15. 1/F
+	int16_t rot_re;		// Q15. exp(j*w*N)
+	int16_t rot_im;
+	float half_bin;		// fs/(2*N)
+
+	int16_t hist_re[COHERENT_GOERTZEL_MAX_FRAMES];		// Q15. z/F
+	int16_t hist_im[COHERENT_GOERTZEL_MAX_FRAMES];
+	int16_t prev_re;	// Q15. z of the previous frame.
+	int16_t prev_im;
+	int16_t phase_diff;
 };
 
 #endif
@@ -0,0 +1,182 @@
+/*==============================================================================
+* @brief	History of the magnitudes with the sliding min, max and percentile.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <assert.h>
+#include <string.h>
+
+#include "history.hpp"
+
+
+MagnitudeHistory::MagnitudeHistory(int window)
+{
+	setWindow(window);
+}
+
+void MagnitudeHistory::setWindow(int frames)
+{
+	assert((0 < frames) && (frames <= MAGNITUDE_HISTORY_MAX));
+
+	window = frames;
+	min.setWindow(frames);
+	max.setWindow(frames);
+	reset();
+}
+
+void MagnitudeHistory::reset(void)
+{
+	count = 0;
+	pos = 0;
+	memset(histogram, 0, sizeof(histogram));
+	min.reset();
+	max.reset();
+}
+
+void MagnitudeHistory::push(int16_t magnitude)
+{
+	if(magnitude < 0) {
+		magnitude = 0;
+	}
+
+	if(window == count) {
+		histogram[ring[pos] >> MAGNITUDE_HISTORY_BIN_SHIFT]--;
+	} else {
+		count++;
+	}
+	histogram[magnitude >> MAGNITUDE_HISTORY_BIN_SHIFT]++;
+
+	ring[pos] = magnitude;
+	pos = (window - 1 == pos)? 0 : pos + 1;
+
+	min.push(magnitude);
+	max.push(magnitude);
+}
+
+int16_t MagnitudeHistory::getPercentile(int16_t p) const
+{
+	if(0 == count) {
+		return 0;
+	}
+
+	// Rank in the window.
+	int32_t rank = ((int32_t)p*count) >> 15;
+	int32_t below = 0;
+
+	for(int k = 0; k < MAGNITUDE_HISTORY_BINS; k++) {
+		if(rank < below + histogram[k]) {
+			int32_t level = (k << MAGNITUDE_HISTORY_BIN_SHIFT)
+						  + (((rank - below) << MAGNITUDE_HISTORY_BIN_SHIFT) + (1 << MAGNITUDE_HISTORY_BIN_SHIFT)/2)/histogram[k];
+
+			level = (level < getMin())? getMin() : level;
+			level = (getMax() < level)? getMax() : level;
+			return level;
+		}
+		below += histogram[k];
+	}
+	return getMax();
+}
+
+
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include "f2q.h"
+
+/**
+* @brief	Checks against sorting the window with the keyed tone and the monotonic ramps,
+*			and the time per frame.
+*/
+int main()
+{
+	const int num = 20000;
+	static const char* const name[] = { "keyed", "rising", "falling" };
+	const int vectors = sizeof(name)/sizeof(name[0]);
+	int16_t* mag = new int16_t[num];
+
+	printf("%8s %8s %12s %14s %14s %14s   (bin = %d)\n", "input", "window", "min/max", "p10 err(max)", "p50 err(max)", "p90 err(max)",
+			1 << MAGNITUDE_HISTORY_BIN_SHIFT);
+	for(int v = 0; v < vectors; v++) {
+		// Noise with the keyed tone of the slowly changing level, or the ramps of 10000 frames.
+		srand(1);
+		for(int n = 0; n < num; n++) {
+			int level = 8000 + 6000*((n/2000)%3);
+			int ramp = 3*(n%10000);
+			mag[n] = (1 == v)? ramp : (2 == v)? 30000 - ramp
+					: (0 == (n/12)%2)? level + rand()%2000 : rand()%3000;
+		}
+
+		for(int window = 16; window <= MAGNITUDE_HISTORY_MAX; window *= 4) {
+			MagnitudeHistory history(window);
+			int16_t sorted[MAGNITUDE_HISTORY_MAX];
+			int minmax = 0;
+			int err[3] = { 0, 0, 0 };
+			const float p[3] = { 0.1, 0.5, 0.9 };
+
+			for(int n = 0; n < num; n++) {
+				history.push(mag[n]);
+
+				int c = history.getCount();
+				auto range = std::minmax_element(mag + n + 1 - c, mag + n + 1);
+				minmax += (*range.first != history.getMin()) || (*range.second != history.getMax());
+
+				std::copy(mag + n + 1 - c, mag + n + 1, sorted);
+				std::sort(sorted, sorted + c);
+				for(int i = 0; i < 3; i++) {
+					int e = abs(history.getPercentile(p[i]*32768) - sorted[(int)(p[i]*c)]);
+					err[i] = std::max(err[i], e);
+				}
+			}
+			printf("%8s %8d %12s %14d %14d %14d\n", name[v], window, (0 == minmax)? "exact" : "NG", err[0], err[1], err[2]);
+		}
+	}
+
+	// Time per frame of push() and the queries.
+	MagnitudeHistory history(MAGNITUDE_HISTORY_MAX);
+	volatile int32_t sink = 0;
+	clock_t t = clock();
+	for(int rep = 0; rep < 100; rep++) {
+		for(int n = 0; n < num; n++) {
+			history.push(mag[n]);
+			sink = sink + history.getMin() + history.getMax() + history.getPercentile(F2Q15(0.5));
+		}
+	}
+	printf("%.1f ns/frame with window %d\n", 1e9*(clock() - t)/CLOCKS_PER_SEC/100/num, MAGNITUDE_HISTORY_MAX);
+
+	delete[] mag;
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,111 @@
+/*==============================================================================
+* @brief	History of the magnitudes with the sliding min, max and percentile.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_HISTORY_HPP
+#define	_HISTORY_HPP
+
+#include <stdint.h>
+#include "sliding.hpp"
+
+//******** Configurations ********************************************
+#define	MAGNITUDE_HISTORY_MAX			256		// Max. frames of the window. Power of 2.
+#define	MAGNITUDE_HISTORY_LOG2_BINS		5		// 32 bins of the histogram over [0, 1) in Q15.
+//--------------------------------------------------------------------
+#define	MAGNITUDE_HISTORY_BINS			(1 << MAGNITUDE_HISTORY_LOG2_BINS)
+#define	MAGNITUDE_HISTORY_BIN_SHIFT		(15 - MAGNITUDE_HISTORY_LOG2_BINS)
+
+/**
+* @brief	The magnitudes of the last window frames, with the min and max by the
+*			monotonic deques and the histogram of MAGNITUDE_HISTORY_BINS bins.
+*
+* @remark	push() is O(1) amortized: the new magnitude enters and the oldest
+*			leaves the deques and the histogram. getMin() and getMax() are O(1).
+*			getPercentile() scans the fixed number of bins and interpolates in
+*			the bin, so it doesn't depend on the window. No heap.
+*/
+class MagnitudeHistory {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] window		Frames of the window. 1 <= window <= MAGNITUDE_HISTORY_MAX.
+	*/
+	MagnitudeHistory(int window = MAGNITUDE_HISTORY_MAX);
+
+	/**
+	* @brief	Resize the window and clear the history.
+	*/
+	void setWindow(int frames);
+	int getWindow(void) const		{ return window; }
+
+	void reset(void);
+
+	/**
+	* @brief	Add the magnitude of a frame. Negative is 0.
+	*/
+	void push(int16_t magnitude);
+
+	/**
+	* @brief	The number of the magnitudes in the window. = min(pushed, window).
+	*/
+	int getCount(void) const		{ return count; }
+
+	int16_t getMin(void) const		{ return (0 < count)? min.get() : 0; }
+	int16_t getMax(void) const		{ return (0 < count)? max.get() : 0; }
+
+	/**
+	* @brief	Approximate percentile of the window.
+	*
+	* @param[in] p		Fraction of the magnitudes below the result. Q15
+	*
+	* @return	Magnitude interpolated in the bin, clamped to [getMin(), getMax()].
+	*/
+	int16_t getPercentile(int16_t p) const;
+
+	/**
+	* @brief	Histogram of the window. MAGNITUDE_HISTORY_BINS bins.
+	*			Bin k counts [k, k + 1) << MAGNITUDE_HISTORY_BIN_SHIFT.
+	*/
+	const uint16_t* getHistogram(void) const	{ return histogram; }
+
+private:
+	int window;
+	int count;
+	int pos;
+	int16_t ring[MAGNITUDE_HISTORY_MAX];
+	uint16_t histogram[MAGNITUDE_HISTORY_BINS];
+	SlidingMin<int16_t, MAGNITUDE_HISTORY_MAX> min;
+	SlidingMax<int16_t, MAGNITUDE_HISTORY_MAX> max;
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
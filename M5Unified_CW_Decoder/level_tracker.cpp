@@ -0,0 +1,188 @@
+/*==============================================================================
+* @brief	Noise floor and mark level trackers for the mark/space threshold.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <cmath>
+#include "basic_op.h"
+#include "f2q.h"
+
+#include "level_tracker.hpp"
+
+
+LevelTracker::LevelTracker(int16_t floor, float frame_rate)
+	: noise(0), mark(0), floor(floor), threshold(floor), state(false)
+{
+	noise_up	= coefficient(LEVEL_TRACKER_NOISE_UP_MS, frame_rate);
+	noise_down	= coefficient(LEVEL_TRACKER_NOISE_DOWN_MS, frame_rate);
+	mark_up		= coefficient(LEVEL_TRACKER_MARK_UP_MS, frame_rate);
+	mark_down	= coefficient(LEVEL_TRACKER_MARK_DOWN_MS, frame_rate);
+	mark_decay	= coefficient(LEVEL_TRACKER_MARK_DECAY_MS, frame_rate);
+}
+
+/**
+* @brief	Coefficient of the one-pole tracker. = 1 - (1/e)^(T/time_constant)
+*/
+int16_t LevelTracker::coefficient(float ms, float frame_rate)
+{
+	return F2Q15((1.0 - exp(-1000.0/(ms*frame_rate))));
+}
+
+/**
+* @brief	level += coef*(in - level), with coef = up or down by the sign.
+*/
+inline int32_t LevelTracker::track(int32_t level, int16_t in, int16_t up, int16_t down)
+{
+	int16_t diff = sub(in, round_fx(level));
+	return L_mac(level, diff, (0 <= diff)? up : down);
+}
+
+bool LevelTracker::push(int16_t magnitude)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_SMOOTHER);
+
+	int16_t n = round_fx(noise);
+	int16_t span = sub(round_fx(mark), n);
+
+	threshold = s_max(floor, add(n, mult(span, F2Q15(LEVEL_TRACKER_THRESHOLD))));
+	int16_t hysteresis = mult(span, F2Q15(LEVEL_TRACKER_HYSTERESIS));
+
+	if(state) {
+		state = !(magnitude < sub(threshold, hysteresis));
+	} else {
+		state = (add(threshold, hysteresis) < magnitude);
+	}
+
+	if(state) {
+		mark = track(mark, magnitude, mark_up, mark_down);
+	} else {
+		noise = track(noise, magnitude, noise_up, noise_down);
+		mark = L_mac(mark, sub(n, round_fx(mark)), mark_decay);
+	}
+	mark = L_max(mark, noise);
+
+	return state;
+}
+
+
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "slicer.hpp"
+
+/**
+* @brief	Gaussian random number.
+*/
+static float gauss(void)
+{
+	float u1 = (rand() + 1.0f)/(RAND_MAX + 2.0f);
+	float u2 = (rand() + 1.0f)/(RAND_MAX + 2.0f);
+	return sqrtf(-2*logf(u1))*cosf(2*M_PI*u2);
+}
+
+/**
+* @brief	Simulated magnitudes of the keyed tone with QSB in noise. Compares the
+*			Smoother threshold of M5Unified_CW_Decoder.ino with LevelTracker and
+*			OtsuSlicer of slicer.cpp.
+*
+*	e.g.	gcc -O2 -c basic_op.c wmops.c && g++ -O2 -c slicer.cpp history.cpp
+*			g++ -O2 -DMODULE_DEBUG level_tracker.cpp slicer.o history.o basic_op.o wmops.o -o level_tracker && ./level_tracker 10 12
+*/
+int main(int argc, char* argv[])
+{
+	const float frame_rate = 200;			// 8000 Hz / 40
+	const float snr_db = (1 < argc)? atof(argv[1]) : 10;
+	const float qsb_db = (2 < argc)? atof(argv[2]) : 12;
+	const int num = 60*frame_rate;
+
+	// Smoother of USE_PARAMETERS_M5UNIFIED.
+	const int16_t smoothing = F2Q15(1.f/6);
+	const int16_t magnitudelimit_low = F2Q15(0.12);
+	const float magnitude_threshold = 0.7;
+
+	// 20 WPM dots (60 ms) and dashes of 0.5 with the QSB of qsb_db at 0.2 Hz, as after the AGC.
+	// Noise only in the last 1/4.
+	const float tone = 0.5;
+	const float noise = tone/pow(10, snr_db/20);
+	int16_t* mag = new int16_t[num];
+	bool* key = new bool[num];
+	srand(1);
+	for(int n = 0, next = 0, on = 0; n < num; n++) {
+		if(n == next) {
+			on = !on;
+			next += (on && (rand() & 1))? 36 : 12;
+		}
+		key[n] = on && (n < 3*num/4);
+		float qsb = pow(10, -(1 - cos(2*M_PI*0.2*n/frame_rate))*qsb_db/2/20);
+		float i = gauss()*noise + ((key[n])? tone*qsb : 0);
+		float q = gauss()*noise;
+		mag[n] = F2Q15(std::min(0.99f, sqrtf(i*i + q*q)));
+	}
+
+	printf("SNR %.0f dB, QSB %.0f dB\n", snr_db, qsb_db);
+	printf("%-14s %12s %12s %12s\n", "", "errors(%)", "false marks", "edges");	// Errors while keyed, false marks in noise.
+	static const char* const name[] = { "Smoother", "LevelTracker", "OtsuSlicer" };
+	for(int d = 0; d < 3; d++) {
+		LevelTracker tracker(magnitude_threshold*magnitudelimit_low, frame_rate);
+		OtsuSlicer slicer(magnitude_threshold*magnitudelimit_low, frame_rate);
+		int32_t buf = 0;
+		int errors = 0, false_marks = 0, edges = 0;
+		bool prev = false;
+
+		for(int n = 0; n < num; n++) {
+			bool state;
+			if(0 == d) {
+				int16_t dat = sub(mag[n], round_fx(buf));
+				buf = L_mac(buf, dat, smoothing);
+				int16_t magnitudelimit = std::max(round_fx(buf), magnitudelimit_low);
+				state = magnitude_threshold*magnitudelimit < mag[n];
+			} else if(1 == d) {
+				state = tracker.push(mag[n]);
+			} else {
+				state = slicer.push(mag[n]);
+			}
+
+			errors += (n < 3*num/4) && (state != key[n]);
+			false_marks += (3*num/4 <= n) && state && !prev;
+			edges += (state != prev);
+			prev = state;
+		}
+		printf("%-14s %12.2f %12d %12d\n", name[d], 100.0*errors/(3*num/4), false_marks, edges);
+	}
+
+	delete[] mag;
+	delete[] key;
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,98 @@
+/*==============================================================================
+* @brief	Noise floor and mark level trackers for the mark/space threshold.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_LEVEL_TRACKER_HPP
+#define	_LEVEL_TRACKER_HPP
+
+#include "basic_op.h"
+
+//******** Configurations ********************************************
+#define	LEVEL_TRACKER_NOISE_UP_MS		500		// Noise floor rises slowly, not following the marks.
+#define	LEVEL_TRACKER_NOISE_DOWN_MS		20		// and falls fast.
+#define	LEVEL_TRACKER_MARK_UP_MS		10		// Mark level rises fast in the marks,
+#define	LEVEL_TRACKER_MARK_DOWN_MS		100		// and follows the QSB in the marks.
+#define	LEVEL_TRACKER_MARK_DECAY_MS		100		// Mark level decays to the noise floor in the spaces, within a few dots.
+#define	LEVEL_TRACKER_THRESHOLD			0.5		// Decision point between the noise floor and the mark level.
+#define	LEVEL_TRACKER_HYSTERESIS		0.125	// +/- of the decision point, relative to mark - noise.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Tracks the noise floor and the mark level of the magnitudes separately,
+*			and decides mark or space at the point between them with hysteresis.
+*
+* @remark	Each level is a one-pole tracker with the asymmetric up and down
+*			coefficients, same as the Smoother. The noise floor is updated in the
+*			spaces and the mark level in the marks, so neither is pulled by the
+*			other. The mark level decays to the noise floor in the spaces, so the
+*			threshold recovers after a fade. The threshold is not lower than floor.
+*/
+class LevelTracker {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] floor			The lowest threshold. Q15
+	* @param[in] frame_rate		Magnitudes per second (Hz).
+	*/
+	LevelTracker(int16_t floor = 0, float frame_rate = 200);
+
+	/**
+	* @brief	Decide a magnitude and update the levels.
+	*
+	* @param[in] magnitude		Magnitude of the Goertzel. Q15
+	*
+	* @return	true: mark, false: space.
+	*/
+	bool push(int16_t magnitude);
+
+	bool isMark(void) const				{ return state; }
+
+	int16_t getThreshold(void) const	{ return threshold; }		// Q15
+	int16_t getNoise(void) const		{ return round_fx(noise); }	// Q15
+	int16_t getMark(void) const			{ return round_fx(mark); }	// Q15
+
+private:
+	int32_t noise;			// Q31
+	int32_t mark;			// Q31
+	int16_t floor;
+	int16_t threshold;
+	bool state;
+
+	int16_t noise_up, noise_down;
+	int16_t mark_up, mark_down, mark_decay;
+
+	static int16_t coefficient(float ms, float frame_rate);
+	static int32_t track(int32_t level, int16_t in, int16_t up, int16_t down);
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -5,11 +5,22 @@
 
 #define	WPM_TEXT_WIDTH	50
 
+Decimator* decimator;
 IIRFilter2* bpf;
+IIRBandpass* bpf_cascade;
 Agc* agc;
 Goertzel* goertzel;	
+SlidingGoertzel* sliding_goertzel;
+ToneTracker* tone_tracker;
+LevelTracker* level_tracker;
+OtsuSlicer* slicer;
 Smoother* smoother;
 
+#ifdef	WMOPS
+	#define	WMOPS_OUTPUT_INTERVAL_MS	5000
+	static float frame_rate;
+#endif
+
 class Plot : public M5Canvas {
 public:
 	Plot(M5GFX* canvas = nullptr) : M5Canvas(canvas)	{ }
@@ -126,6 +137,8 @@ struct SideTone {
 
 void Smoother::smooth(int16_t* out, const int16_t* in, int num)
 {
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_SMOOTHER);
+
 	for(; 0 < num; num--) {
 		int16_t dat = (*in++ - round_fx(buf));
 		buf = L_mac(buf, dat, (0 <= dat)? up_coef : down_coef);
@@ -171,15 +184,38 @@ static void Splash(void)
 	splash.deleteSprite();
 }
 
-void m5un_setup(float target_freq, float sampling_freq, int numof_testdata, int16_t smoothing_up, int16_t smoothing_down)
+void m5un_setup(float target_freq, float sampling_freq, int numof_testdata, int16_t smoothing_up, int16_t smoothing_down, int hop, int decimation, const IIR2Coefficients* bpf_coef, int bpf_order, float bpf_bandwidth, IIR_DESIGN bpf_design)
 {
-	bpf = new IIRFilter2(target_freq, sampling_freq, FILTER_TYPE_BPF, 0.7071);
+	/// The stages after the decimator run at sampling_freq/decimation with the same time spans.
+	if(1 < decimation) {
+		decimator = new Decimator(decimation);
+		sampling_freq /= decimation;
+		numof_testdata /= decimation;
+		hop /= decimation;
+	}
+
+	/// 0 < bpf_order: the cascade of bpf_order sections instead of bpf. Designed here, not in the first audio frame.
+	/// bpf_coef: designed at compile time by IIRFilter2::coefficients().
+	if(0 < bpf_order) {
+		bpf_cascade = new IIRBandpass(target_freq, bpf_bandwidth, sampling_freq, bpf_order, bpf_design);
+	} else {
+		bpf = (nullptr != bpf_coef)? new IIRFilter2(*bpf_coef) : new IIRFilter2(target_freq, sampling_freq, FILTER_TYPE_BPF, 0.7071);
+	}
 	agc = new Agc(0.7, 20.0, 3, 5000, sampling_freq);
 
 	smoother = new Smoother(smoothing_up, smoothing_down);
 
 	goertzel = new Goertzel(target_freq, sampling_freq, numof_testdata, false);
 
+	if(0 < hop) {
+		sliding_goertzel = new SlidingGoertzel(target_freq, sampling_freq, numof_testdata, hop, false);
+	}
+
+#ifdef	WMOPS
+	frame_rate = sampling_freq/((0 < hop)? hop : numof_testdata);
+	wmops_reset();
+#endif
+
 	M5.begin();
 
 	Splash();
@@ -197,6 +233,16 @@ void m5un_loop(int wpm, int state, int16_t magnitude, int16_t magnitudelimit)
 {
 	//	M5.Power.setLed((state)? 255:0);
 
+#ifdef	WMOPS
+	static uint32_t wmops_ms = millis();
+	wmops_frame();
+	if(WMOPS_OUTPUT_INTERVAL_MS <= millis() - wmops_ms) {
+		wmops_output(frame_rate);
+		wmops_reset();
+		wmops_ms = millis();
+	}
+#endif
+
 	plot.write(state, magnitude, magnitudelimit);
 	
 	int32_t x, y, w, h;
@@ -1,14 +1,25 @@
 #ifndef	_M5UN_HPP
 #define	_M5UN_HPP
 
+#include "decimator.hpp"
 #include "filter.hpp"
 #include "agc.hpp"
 #include "goertzel.hpp"
+#include "envelope.hpp"
+#include "tracker.hpp"
+#include "level_tracker.hpp"
+#include "slicer.hpp"
 
 
+extern Decimator* decimator;
 extern IIRFilter2* bpf;
+extern IIRBandpass* bpf_cascade;
 extern Agc* agc;
 extern Goertzel* goertzel;	
+extern SlidingGoertzel* sliding_goertzel;
+extern ToneTracker* tone_tracker;
+extern LevelTracker* level_tracker;
+extern OtsuSlicer* slicer;
 
 extern class Smoother {
 	public:
@@ -22,7 +33,7 @@ extern class Smoother {
 		int32_t buf;
 } *smoother;
 
-extern void m5un_setup(float target_freq, float sampling_freq, int numof_testdata, int16_t smoothing_up, int16_t smoothing_down);
+extern void m5un_setup(float target_freq, float sampling_freq, int numof_testdata, int16_t smoothing_up, int16_t smoothing_down, int hop = 0, int decimation = 1, const IIR2Coefficients* bpf_coef = nullptr, int bpf_order = 0, float bpf_bandwidth = 0, IIR_DESIGN bpf_design = IIR_DESIGN_BUTTERWORTH);
 extern void m5un_loop(int wpm, int state, int16_t magnitude, int16_t magnitudelimit);
 
 extern void m5un_printascii(char ascii);
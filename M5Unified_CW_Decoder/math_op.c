@@ -0,0 +1,234 @@
+/*==============================================================================
+* @brief	Fixed-point math functions built on the Basic Operators.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include "math_op.h"
+
+/**
+*	log2(1 + i/32) in Q15. i = 0...32.
+*/
+static const uint16_t log2_table[33] = {
+	    0,  1455,  2866,  4236,  5568,  6863,  8124,  9352,
+	10549, 11716, 12855, 13968, 15055, 16117, 17156, 18173,
+	19168, 20143, 21098, 22034, 22952, 23852, 24736, 25604,
+	26455, 27292, 28114, 28922, 29717, 30498, 31267, 32024,
+	32768,
+};
+
+/**
+*	atan(2^-i)/pi in Q23. i = 0...15.
+*/
+static const int32_t atan_table[16] = {
+	2097152, 1238021,  654136,  332050,  166669,   83416,   41718,   20860,
+	  10430,    5215,    2608,    1304,     652,     326,     163,      81,
+};
+
+
+/**
+* @brief	Square root.
+*
+* @param[in] L_v1	Q31. L_v1 <= 0 returns 0.
+*
+* @return	Q15. = sqrt(L_v1) rounded to the nearest, saturated to INT16_MAX.
+*
+* @remark	sqrt(L_v1/2^31)*2^15 = sqrt(2*L_v1)/2. The integer square root of
+*			2*L_v1 is computed digit by digit, starting from the leading bit
+*			found by norm_l(), then rounded by 1 bit.
+*/
+int16_t sqrt_l(int32_t L_v1)
+{
+	WMOPS_COUNT(sqrt_l);
+
+	if(L_v1 <= 0) {
+		return 0;
+	}
+
+	uint32_t x = (uint32_t)L_v1<<1;
+	uint32_t root = 0;
+	uint32_t bit = (uint32_t)1<<((31 - norm_l(L_v1)) & ~1);
+	WMOPS_UNCOUNT(norm_l);
+
+	for( ; 0 != bit; bit >>= 2) {
+		if(root + bit <= x) {
+			x -= root + bit;
+			root = (root>>1) + bit;
+		} else {
+			root >>= 1;
+		}
+	}
+
+	root = (root + 1)>>1;
+	return (INT16_MAX < root)? INT16_MAX : (int16_t)root;
+}
+
+
+/**
+* @brief	Base 2 logarithm.
+*
+* @param[in] L_v1	Q31. L_v1 <= 0 returns INT16_MIN.
+*
+* @return	Q10. = log2(L_v1), -31.0 <= return value <= 0.
+*
+* @remark	L_v1 is normalized to 2^30 <= m < 2^31 by norm_l(), then
+*			log2(L_v1) = log2(m/2^30) - 1 - norm_l(L_v1).
+*			log2(m/2^30) is interpolated linearly in the 32 segments of the table.
+*			The error is less than 0.7 LSB including the rounding.
+*/
+int16_t log2_l(int32_t L_v1)
+{
+	WMOPS_COUNT(log2_l);
+
+	if(L_v1 <= 0) {
+		return INT16_MIN;
+	}
+
+	int16_t exp = norm_l(L_v1);
+	WMOPS_UNCOUNT(norm_l);
+	uint32_t m = (uint32_t)L_v1<<exp;
+
+	int index = (m>>25) & 0x1f;
+	int32_t frac = (m>>10) & 0x7fff;			// Q15
+	int32_t diff = log2_table[index + 1] - log2_table[index];
+	int32_t mant = log2_table[index] + ((diff*frac)>>15);		// Q15
+
+	int32_t L_log2 = (int32_t)(-1 - exp)*32768 + mant;			// Q15
+	return (int16_t)((L_log2 + 16)>>5);
+}
+
+/**
+* @brief	Arc tangent of v1/v2.
+*
+* @param[in] v1		y.
+* @param[in] v2		x. atan2_s(0, 0) returns 0.
+*
+* @return	Q15 in units of pi. = atan2(v1, v2)/pi, -1.0 <= return value < 1.0.
+*			pi is saturated to INT16_MAX.
+*
+* @remark	The vector is rotated into the right half plane, then rotated to
+*			the x axis by 16 CORDIC iterations in the vectoring mode. The
+*			angle is accumulated in Q23 and rounded, so the error is less than 1 LSB.
+*/
+int16_t atan2_s(int16_t v1, int16_t v2)
+{
+	WMOPS_COUNT(atan2_s);
+
+	if((0 == v1) && (0 == v2)) {
+		return 0;
+	}
+
+	int32_t x = (int32_t)v2<<14;		// |x|, |y| * CORDIC gain 1.65 < 2^31
+	int32_t y = (int32_t)v1<<14;
+	int32_t angle = 0;				// Q23
+
+	if(x < 0) {
+		angle = (0 <= y)? (1L<<23) : -(1L<<23);
+		x = -x;
+		y = -y;
+	}
+
+	for(int i = 0; i < 16; i++) {
+		int32_t dx = y>>i;
+		int32_t dy = x>>i;
+
+		if(0 < y) {
+			x += dx;
+			y -= dy;
+			angle += atan_table[i];
+		} else {
+			x -= dx;
+			y += dy;
+			angle -= atan_table[i];
+		}
+	}
+
+	angle = (angle + 128)>>8;
+	return (INT16_MAX < angle)? INT16_MAX : (angle < INT16_MIN)? INT16_MIN : (int16_t)angle;
+}
+
+
+/*-------------------------------------------------------------------------------
+*	Module Debug
+-------------------------------------------------------------------------------*/
+#ifdef	MODULE_DEBUG
+/*
+*	Compare with the floating-point functions.
+*
+*	e.g.	gcc -O2 -c basic_op.c wmops.c
+*			gcc -O2 -DMODULE_DEBUG math_op.c basic_op.o wmops.o -lm -o math_op && ./math_op
+*/
+#include <stdio.h>
+#include <math.h>
+
+int main(void)
+{
+	int sqrt_errors = 0;
+	double log2_max_error = 0;
+
+	for(int64_t L = 1; L <= INT32_MAX; L += 1 + (L>>12)) {
+		int16_t s = sqrt_l((int32_t)L);
+		double ref = floor(sqrt(L/2147483648.0)*32768.0 + 0.5);
+		if(32767 < ref) {
+			ref = 32767;
+		}
+		if(s != ref) {
+			if(sqrt_errors++ < 8) {
+				printf("sqrt_l(%08x) = %d, expected %.0f\n", (unsigned)L, s, ref);
+			}
+		}
+
+		double err = fabs(log2_l((int32_t)L)/1024.0 - log2(L/2147483648.0));
+		if(log2_max_error < err) {
+			log2_max_error = err;
+		}
+	}
+
+	double atan2_max_error = 0;
+	for(int v1 = -32768; v1 < 32768; v1 += 97) {
+		for(int v2 = -32768; v2 < 32768; v2 += 89) {
+			double ref = atan2(v1, v2)/M_PI*32768.0;
+			if(32767 < ref) {
+				ref = 32767;
+			}
+			double err = fabs(atan2_s(v1, v2) - ref);
+			if(atan2_max_error < err) {
+				atan2_max_error = err;
+			}
+		}
+	}
+
+	printf("sqrt_l: %d errors\n", sqrt_errors);
+	printf("log2_l: max error %f (%.3f LSB)\n", log2_max_error, log2_max_error*1024);
+	printf("atan2_s: max error %.3f LSB\n", atan2_max_error);
+
+	return (0 == sqrt_errors)? 0 : 1;
+}
+#endif	/* MODULE_DEBUG */
+/*==============================================================================
+*	End
+*===============================================================================*/
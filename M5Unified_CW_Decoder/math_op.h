@@ -0,0 +1,76 @@
+/*==============================================================================
+* @brief	Fixed-point math functions built on the Basic Operators.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef _MATH_OP_H
+#define _MATH_OP_H
+
+#include "basic_op.h"
+
+#ifdef	__cplusplus
+	extern "C" {
+#endif
+
+/**
+* @brief	Square root.
+*
+* @param[in] L_v1	Q31. L_v1 <= 0 returns 0.
+*
+* @return	Q15. = sqrt(L_v1) rounded to the nearest, saturated to INT16_MAX.
+*/
+int16_t sqrt_l(int32_t L_v1);
+
+/**
+* @brief	Base 2 logarithm.
+*
+* @param[in] L_v1	Q31. L_v1 <= 0 returns INT16_MIN.
+*
+* @return	Q10. = log2(L_v1), -31.0 <= return value <= 0.
+*/
+int16_t log2_l(int32_t L_v1);
+
+/**
+* @brief	Arc tangent of v1/v2.
+*
+* @param[in] v1		y.
+* @param[in] v2		x. atan2_s(0, 0) returns 0.
+*
+* @return	Q15 in units of pi. = atan2(v1, v2)/pi, -1.0 <= return value < 1.0.
+*			pi is saturated to INT16_MAX.
+*/
+int16_t atan2_s(int16_t v1, int16_t v2);
+
+#ifdef	__cplusplus
+	}
+#endif
+
+#endif
+/*==============================================================================
+*	End
+==============================================================================*/
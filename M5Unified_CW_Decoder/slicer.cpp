@@ -0,0 +1,146 @@
+/*==============================================================================
+* @brief	Mark/space slicer by the Otsu threshold of the magnitude histogram.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <cmath>
+#include "slicer.hpp"
+#include "basic_op.h"
+#include "f2q.h"
+
+
+OtsuSlicer::OtsuSlicer(int16_t floor, float frame_rate)
+	: floor(floor), threshold(floor), hysteresis(0), skip(0), frames(0), state(false)
+{
+	int window = OTSU_SLICER_WINDOW_MS*frame_rate/1000 + 0.5f;
+	window = (window < 1)? 1 : window;
+	step = (window + MAGNITUDE_HISTORY_MAX - 1)/MAGNITUDE_HISTORY_MAX;
+	history.setWindow(window/step);
+
+	decay = F2Q15((1.0 - exp(-1000.0*OTSU_SLICER_INTERVAL/(OTSU_SLICER_DECAY_MS*frame_rate))));
+}
+
+bool OtsuSlicer::push(int16_t magnitude)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_SMOOTHER);
+
+	if(state) {
+		state = (sub(threshold, hysteresis) < magnitude);
+	} else {
+		state = (add(threshold, hysteresis) < magnitude);
+	}
+
+	if(step <= ++skip) {
+		skip = 0;
+		history.push(magnitude);
+	}
+	if(OTSU_SLICER_INTERVAL <= ++frames) {
+		frames = 0;
+		search();
+	}
+	return state;
+}
+
+/**
+* @brief	Otsu threshold of the histogram.
+*
+* @remark	With the counts n[k] of the bins, N = sum(n[k]) and S = sum(k*n[k]), the
+*			between-class variance at the edge after the bin k is proportional to
+*			(S*w - s*N)^2/(w*(N - w)), where w and s are the sums up to k.
+*			It is compared by the cross products in 64 bit.
+*/
+void OtsuSlicer::search(void)
+{
+	const uint16_t* n = history.getHistogram();
+
+	int32_t N = 0, S = 0;
+	for(int k = 0; k < MAGNITUDE_HISTORY_BINS; k++) {
+		N += n[k];
+		S += k*n[k];
+	}
+
+	int best = -1;
+	int64_t best_num = 0, best_den = 1;
+	int32_t best_w = 0, best_s = 0;
+	int32_t w = 0, s = 0;
+
+	for(int k = 0; k < MAGNITUDE_HISTORY_BINS - 1; k++) {
+		w += n[k];
+		s += k*n[k];
+		if((0 == w) || (N == w)) {
+			continue;
+		}
+
+		int64_t d = (int64_t)S*w - (int64_t)s*N;
+		int64_t num = d*d/N;
+		int64_t den = (int64_t)w*(N - w);
+		if(best_den*num > best_num*den) {
+			best = k;
+			best_num = num;
+			best_den = den;
+			best_w = w;
+			best_s = s;
+		}
+	}
+	if(best < 0) {
+		hold();
+		return;
+	}
+
+	// Means of the classes in bins, compared as (S - s)/(N - w) >= RATIO*s/w.
+	// The lower class is at least 0.5 bin, the center of bin 0.
+	int64_t mark = (int64_t)2*(S - best_s) + (N - best_w);
+	int64_t space = (int64_t)2*best_s + best_w;
+	if(mark*best_w < OTSU_SLICER_MIN_RATIO*space*(N - best_w)) {
+		hold();
+		return;
+	}
+
+	int16_t level = (best + 1) << MAGNITUDE_HISTORY_BIN_SHIFT;
+	threshold = (level < floor)? floor : level;
+
+	// Difference between the means in Q15 = (mark/(N - w) - space/w)/2 bins.
+	int32_t diff = ((mark*best_w - space*(N - best_w)) << (MAGNITUDE_HISTORY_BIN_SHIFT - 1))/((int64_t)best_w*(N - best_w));
+	hysteresis = mult(extract_l(L_min(diff, INT16_MAX)), F2Q15(OTSU_SLICER_HYSTERESIS));
+}
+
+/**
+* @brief	Decays the held threshold down to the percentile of the window, so a
+*			fade doesn't leave the threshold above the marks.
+*/
+void OtsuSlicer::hold(void)
+{
+	int16_t level = s_max(floor, history.getPercentile(F2Q15(OTSU_SLICER_DECAY_PERCENTILE)));
+	if(level < threshold) {
+		threshold = add(threshold, mult(sub(level, threshold), decay));
+	}
+}
+
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,104 @@
+/*==============================================================================
+* @brief	Mark/space slicer by the Otsu threshold of the magnitude histogram.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_SLICER_HPP
+#define	_SLICER_HPP
+
+#include "history.hpp"
+
+//******** Configurations ********************************************
+#define	OTSU_SLICER_WINDOW_MS		500		// Time of the histogram.
+#define	OTSU_SLICER_INTERVAL		8		// Frames between the threshold searches.
+#define	OTSU_SLICER_MIN_RATIO		3		// Mean of the marks / mean of the spaces to accept the threshold.
+#define	OTSU_SLICER_HYSTERESIS		0.125	// Of the difference between the means, on each side of the threshold.
+#define	OTSU_SLICER_DECAY_MS		100		// Held threshold decays down to the percentile of the window,
+#define	OTSU_SLICER_DECAY_PERCENTILE	0.4	// not lower than floor.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Slices the magnitudes at the Otsu threshold of the recent magnitudes.
+*
+* @remark	The histogram of MagnitudeHistory is searched for the bin edge with
+*			the max. between-class variance every OTSU_SLICER_INTERVAL frames,
+*			in integers over the fixed bins. The slicing is a comparison per
+*			frame with the hysteresis. While the classes are not separated by
+*			OTSU_SLICER_MIN_RATIO, e.g. in a fade or in the noise only, the
+*			threshold is held and decays down to OTSU_SLICER_DECAY_PERCENTILE of
+*			the window, so the marks after a fade are not lost under the old
+*			threshold. The threshold is not lower than floor.
+*
+*			When OTSU_SLICER_WINDOW_MS has more frames than MAGNITUDE_HISTORY_MAX,
+*			every step-th magnitude goes to the histogram, so the window keeps
+*			the time, e.g. step 2 and 200 magnitudes at 800 frames/s of the
+*			sliding Goertzel.
+*/
+class OtsuSlicer {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] floor			The lowest threshold. Q15
+	* @param[in] frame_rate		Magnitudes per second (Hz).
+	*/
+	OtsuSlicer(int16_t floor = 0, float frame_rate = 200);
+
+	/**
+	* @brief	Slice a magnitude and update the histogram.
+	*
+	* @param[in] magnitude		Magnitude of the Goertzel. Q15
+	*
+	* @return	true: mark, false: space.
+	*/
+	bool push(int16_t magnitude);
+
+	bool isMark(void) const				{ return state; }
+	int16_t getThreshold(void) const	{ return threshold; }	// Q15
+
+	const MagnitudeHistory& getHistory(void) const	{ return history; }
+
+private:
+	MagnitudeHistory history;
+	int16_t floor;
+	int16_t threshold;
+	int16_t hysteresis;
+	int16_t decay;			// Per search. Q15
+	int step;				// Frames per magnitude of the histogram.
+	int skip;
+	int frames;
+	bool state;
+
+	void search(void);
+	void hold(void);
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
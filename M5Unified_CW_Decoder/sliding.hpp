@@ -0,0 +1,114 @@
+/*==============================================================================
+* @brief	Sliding window maximum and minimum by the monotonic deque.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_SLIDING_HPP
+#define	_SLIDING_HPP
+
+#include <stdint.h>
+
+/**
+* @brief	Maximum (or minimum) of the last window values, O(1) amortized per value.
+*
+* @tparam T			Type of the values.
+* @tparam N			Capacity, a power of 2. The window is at most N.
+* @tparam IS_MIN	Minimum instead of maximum.
+*
+* @remark	The deque holds the candidates in decreasing (increasing for IS_MIN)
+*			order of the value. The front is dropped when it leaves the window,
+*			then a new value drops the candidates it dominates from the back,
+*			so each value is pushed and popped once. At most window - 1
+*			candidates are left before the insertion, so N slots hold window = N.
+*/
+template <typename T, int N, bool IS_MIN = false>
+class SlidingExtremum {
+	static_assert((0 < N) && (0 == (N & (N - 1))), "N must be a power of 2");
+
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] window	The number of the last values. 1 <= window <= N.
+	*/
+	SlidingExtremum(int window = N) : window(window), head(0), tail(0), time(0)	{ ; }
+
+	/**
+	* @brief	Resize the window and clear the values.
+	*/
+	void setWindow(int w)		{ window = w;	reset(); }
+	int getWindow(void) const	{ return window; }
+
+	void reset(void)			{ head = tail = time = 0; }
+
+	/**
+	* @brief	Add a value.
+	*
+	* @return	The maximum (minimum) of the last window values including x.
+	*/
+	T push(T x)
+	{
+		if((head != tail) && (static_cast<uint32_t>(time - idx[head & (N - 1)]) >= static_cast<uint32_t>(window))) {
+			head++;
+		}
+		while((head != tail) && dominates(x, val[(tail - 1) & (N - 1)])) {
+			tail--;
+		}
+		val[tail & (N - 1)] = x;
+		idx[tail & (N - 1)] = time;
+		tail++;
+		time++;
+
+		return val[head & (N - 1)];
+	}
+
+	/**
+	* @brief	The maximum (minimum) of the last window values. Not valid before push().
+	*/
+	T get(void) const			{ return val[head & (N - 1)]; }
+
+private:
+	static bool dominates(T x, T y)	{ return (IS_MIN)? (x <= y) : (y <= x); }
+
+	int window;
+	uint32_t head, tail;		// Deque of the candidates. [head, tail).
+	uint32_t time;				// The number of values pushed.
+	T val[N];
+	uint32_t idx[N];			// Time of the candidates.
+};
+
+template <typename T, int N>
+using SlidingMax = SlidingExtremum<T, N, false>;
+
+template <typename T, int N>
+using SlidingMin = SlidingExtremum<T, N, true>;
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
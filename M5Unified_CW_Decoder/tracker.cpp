@@ -0,0 +1,279 @@
+/*==============================================================================
+* @brief	Automatic tone frequency tracking.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include <cmath>
+#include <stdlib.h>
+#include <string.h>
+#include "basic_op.h"
+
+#include "tracker.hpp"
+
+
+ToneTracker::ToneTracker(float freq, float sampling_freq, int N, float min_freq, float max_freq, float Q)
+	: num(0), den(0), marks(0), N(N), count(0), frame(new int16_t[N]), frames(0),
+	  fine(N), coarse(N), bpf(nullptr), goertzel(nullptr), sliding_goertzel(nullptr)
+{
+	// Half a bin of the Goertzel. = fs/N/2.
+	span = static_cast<int>(sampling_freq/(2*N*TONE_TRACKER_STEP_HZ) + 0.5f);
+	if(span < 1) {
+		span = 1;
+	}
+
+	// The grid is extended by span, so that the fine bins are in the tables.
+	base_freq = min_freq - span*TONE_TRACKER_STEP_HZ;
+	steps = static_cast<int>((max_freq - min_freq)/TONE_TRACKER_STEP_HZ) + 1 + 2*span;
+	if(TONE_TRACKER_MAX_STEPS < steps) {
+		steps = TONE_TRACKER_MAX_STEPS;
+	}
+	lower = span;
+	upper = steps - 1 - span;
+
+	for(int i = 0; i < steps; i += IIR_DESIGN_CHUNK) {
+		float f[IIR_DESIGN_CHUNK];
+		int n = (steps - i < IIR_DESIGN_CHUNK)? steps - i : IIR_DESIGN_CHUNK;
+
+		for(int k = 0; k < n; k++) {
+			f[k] = base_freq + (i + k)*TONE_TRACKER_STEP_HZ;
+			goertzel_coef[i + k] = Goertzel::coefficient(f[k], sampling_freq, N, false);
+		}
+		IIRFilter2::design(&bpf_coef[i], f, n, sampling_freq, FILTER_TYPE_BPF, Q);
+	}
+
+	for(int k = 0; k < TONE_TRACKER_COARSE_BINS; k++) {
+		coarse_index[k] = lower + (k*(upper - lower) + (TONE_TRACKER_COARSE_BINS - 1)/2)/(TONE_TRACKER_COARSE_BINS - 1);
+		coarse.setCoef(k, goertzel_coef[coarse_index[k]]);
+		energy[k] = 0;
+	}
+
+	index = static_cast<int>((freq - base_freq)/TONE_TRACKER_STEP_HZ + 0.5f);
+	index = (index < lower)? lower : (upper < index)? upper : index;
+	target = index;
+
+	apply();
+}
+
+void ToneTracker::attach(IIR2DirectFormI* bpf_ptr, Goertzel* goertzel_ptr, SlidingGoertzel* sliding_goertzel_ptr)
+{
+	bpf = bpf_ptr;
+	goertzel = goertzel_ptr;
+	sliding_goertzel = sliding_goertzel_ptr;
+
+	apply();
+}
+
+void ToneTracker::push(const int16_t* in, size_t num, bool mark)
+{
+	WMOPS_STAGE_SCOPE(WMOPS_STAGE_TRACKER);
+
+	while(0 < num) {
+		size_t len = N - count;
+		if(num < len) {
+			len = num;
+		}
+
+		memcpy(frame + count, in, len*sizeof(int16_t));
+		in += len;
+		num -= len;
+		count += len;
+
+		if(N <= count) {
+			process(mark);
+			count = 0;
+		}
+	}
+}
+
+/**
+* @brief	Estimate the frequency from a frame and retune.
+*/
+void ToneTracker::process(bool mark)
+{
+	if(0 == frames) {
+		search();
+		frames = TONE_TRACKER_COARSE_INTERVAL;
+	}
+	frames--;
+
+	if(mark && (index == target)) {		// Don't disturb slewing to the coarse peak.
+		estimate();
+	}
+
+	retune();
+}
+
+/**
+* @brief	Coarse search. Smooth the energies of the bins, and move the target
+*			to the strongest bin when it is 6 dB stronger than the bin nearest
+*			to the current frequency.
+*/
+void ToneTracker::search(void)
+{
+	int32_t magSq[TONE_TRACKER_COARSE_BINS];
+	coarse.getSquaredMagnitude(magSq, frame);
+
+	int peak = 0;
+	int near = 0;
+	for(int k = 0; k < TONE_TRACKER_COARSE_BINS; k++) {
+		energy[k] = L_add(energy[k], L_shr(L_sub(magSq[k], energy[k]), 2));
+
+		if(energy[peak] < energy[k]) {
+			peak = k;
+		}
+		if(abs(coarse_index[k] - index) < abs(coarse_index[near] - index)) {
+			near = k;
+		}
+	}
+
+	if(L_shl(energy[near], 2) < energy[peak]) {
+		target = coarse_index[peak];
+	}
+}
+
+/**
+* @brief	Fine estimate by the parabola through the magnitudes of 3 bins.
+*
+* @remark	offset = span*(m[2] - m[0])/(2*(2*m[1] - m[0] - m[2])).
+*			The numerator and the denominator are summed over the frames, which
+*			averages out the leakage of the negative frequency depending on the
+*			phase. When m[1] is not the peak, it climbs by span toward the larger side.
+*/
+void ToneTracker::estimate(void)
+{
+	int32_t magSq[3];
+	int16_t mag[3];
+	fine.getSquaredMagnitude(magSq, frame);
+	for(int k = 0; k < 3; k++) {
+		mag[k] = Goertzel::magnitude(magSq[k]);
+	}
+
+	num = L_add(num, L_sub(mag[2], mag[0]));
+	den = L_add(den, L_shl(L_sub(L_shl(mag[1], 1), L_add(mag[0], mag[2])), 1));
+	if(++marks < TONE_TRACKER_FINE_FRAMES) {
+		return;
+	}
+
+	int offset = 0;
+	if(0 == num) {
+		offset = 0;
+	} else if(den <= L_abs(num)) {
+		offset = span;
+	} else {
+		int16_t sh = s_max(0, sub(16, norm_l(den)));		// den < 2^15
+		int16_t frac = div_s(extract_l(L_shr(L_abs(num), sh)), extract_l(L_shr(den, sh)));
+		offset = mult_r(frac, span);
+	}
+
+	target = index + ((num < 0)? -offset : offset);
+	target = (target < lower)? lower : (upper < target)? upper : target;
+
+	num = den = 0;
+	marks = 0;
+}
+
+/**
+* @brief	Slew the current frequency toward the target.
+*/
+void ToneTracker::retune(void)
+{
+	int d = target - index;
+	if(0 == d) {
+		return;
+	}
+
+	if(TONE_TRACKER_SLEW_STEPS < d) {
+		d = TONE_TRACKER_SLEW_STEPS;
+	} else if(d < -TONE_TRACKER_SLEW_STEPS) {
+		d = -TONE_TRACKER_SLEW_STEPS;
+	}
+	index += d;
+
+	apply();
+}
+
+/**
+* @brief	Set the coefficients of the current frequency.
+*/
+void ToneTracker::apply(void)
+{
+	fine.setCoef(0, goertzel_coef[index - span]);
+	fine.setCoef(1, goertzel_coef[index]);
+	fine.setCoef(2, goertzel_coef[index + span]);
+	num = den = 0;
+	marks = 0;
+
+	if(nullptr != bpf) {
+		bpf->setCoefficients(bpf_coef[index]);
+	}
+	if(nullptr != goertzel) {
+		goertzel->setCoef(goertzel_coef[index]);
+	}
+	if(nullptr != sliding_goertzel) {
+		sliding_goertzel->setCoef(goertzel_coef[index]);
+	}
+}
+
+//----------------------------------------------------------------------------------
+#ifdef	MODULE_DEBUG
+
+#include <stdio.h>
+
+int main(int argc, char* argv[])
+{
+	const float fs = 8000;
+	const int N = 40;
+	float tone = (1 < argc)? atof(argv[1]) : 750;
+
+	IIRFilter2 bpf(600, fs, FILTER_TYPE_BPF, 0.7071);
+	Goertzel goertzel(600, fs, N, false);
+	ToneTracker tracker(600, fs, N);
+	tracker.attach(&bpf, &goertzel);
+
+	int16_t in[N];
+	float phase = 0;
+	for(int frame = 0; frame < 400; frame++) {
+		for(int i = 0; i < N; i++) {
+			in[i] = F2Q15(0.3f*sin(phase));
+			phase += 2*M_PI*tone/fs;
+		}
+		tracker.push(in, N, true);
+
+		if(0 == frame % 20) {
+			printf("%4d %7.1f Hz\n", frame, tracker.getFreq());
+		}
+	}
+	printf("tone %.1f Hz, tracked %.1f Hz\n", tone, tracker.getFreq());
+
+	return 0;
+}
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
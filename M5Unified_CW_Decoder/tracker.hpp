@@ -0,0 +1,148 @@
+/*==============================================================================
+* @brief	Automatic tone frequency tracking.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef	_TRACKER_HPP
+#define	_TRACKER_HPP
+
+#include "filter.hpp"
+#include "goertzel.hpp"
+
+//******** Configurations ********************************************
+#define	TONE_TRACKER_STEP_HZ			5		// Frequency grid of the tables.
+#define	TONE_TRACKER_MAX_STEPS			256		// Table size. Limits max_freq - min_freq + fs/N.
+#define	TONE_TRACKER_COARSE_BINS		16		// Bins of the coarse search.
+#define	TONE_TRACKER_COARSE_INTERVAL	8		// Frames between the coarse searches.
+#define	TONE_TRACKER_FINE_FRAMES		4		// Frames averaged by the fine estimate.
+#define	TONE_TRACKER_SLEW_STEPS			2		// Max. steps of retuning per frame.
+//--------------------------------------------------------------------
+
+/**
+* @brief	Tracks the tone frequency and retunes the BPF and the Goertzel.
+*
+* @remark	A coarse search by a GoertzelBank over [min_freq, max_freq] runs every
+*			TONE_TRACKER_COARSE_INTERVAL frames, and jumps to a bin 6 dB stronger
+*			than the bin at the current frequency. While the tone is on, 3 bins
+*			at the current frequency and +/- half a bin around it are computed
+*			every frame, and the peak is interpolated by a parabola averaged
+*			over TONE_TRACKER_FINE_FRAMES frames.
+*			The BPF and Goertzel coefficients are tabled on the grid of
+*			TONE_TRACKER_STEP_HZ at construction, and the frequency is slewed
+*			by TONE_TRACKER_SLEW_STEPS per frame. So retuning allocates nothing,
+*			keeps the filter state and doesn't glitch.
+*/
+class ToneTracker {
+public:
+	/**
+	* @brief Constructor
+	*
+	* @param[in] freq				Initial frequency (Hz).
+	* @param[in] sampling_freq		Sampling frequency (Hz).
+	* @param[in] N					The number of samples of a frame. Same as the Goertzel.
+	* @param[in] min_freq			Lower limit of the tracking (Hz).
+	* @param[in] max_freq			Upper limit of the tracking (Hz).
+	* @param[in] Q					Q of the BPF.
+	*/
+	ToneTracker(float freq = 600, float sampling_freq = 8000, int N = 40,
+				float min_freq = 300, float max_freq = 1200, float Q = 0.7071);
+
+	~ToneTracker() {
+		delete[] frame;
+	}
+
+	ToneTracker(const ToneTracker&) = delete;
+	ToneTracker& operator=(const ToneTracker&) = delete;
+
+	/**
+	* @brief	Set the BPF and the Goertzels to be retuned, and tune them to
+	*			the current frequency.
+	*
+	* @param[in] bpf				BPF. nullptr is not retuned.
+	* @param[in] goertzel			Goertzel. nullptr is not retuned.
+	* @param[in] sliding_goertzel	Sliding Goertzel. nullptr is not retuned.
+	*/
+	void attach(IIR2DirectFormI* bpf, Goertzel* goertzel, SlidingGoertzel* sliding_goertzel = nullptr);
+
+	/**
+	* @brief	Streaming input of the samples before the BPF. Every N samples,
+	*			the frequency is estimated and the attached objects are retuned.
+	*
+	* @param[in] in			The pointer to input samples. in[num].
+	* @param[in] num		The number of samples.
+	* @param[in] mark		true while the tone is detected.
+	*/
+	void push(const int16_t* in, size_t num, bool mark);
+
+	/**
+	* @brief	Current frequency (Hz).
+	*/
+	float getFreq(void) const	{ return base_freq + index*TONE_TRACKER_STEP_HZ; }
+
+private:
+	float base_freq;	// Frequency of the grid 0. = min_freq - span*STEP_HZ.
+	int steps;			// The number of the grid.
+	int span;			// Fine bins are index - span, index, index + span.
+	int lower;			// Tracking range on the grid. = [span, steps - 1 - span].
+	int upper;
+	int index;			// Current frequency on the grid.
+	int target;			// Estimated frequency on the grid.
+
+	int32_t num;		// Sums of the numerator and the denominator of the parabola.
+	int32_t den;
+	int marks;			// Frames in the sums.
+
+	int N;
+	int count;			// Samples in frame[].
+	int16_t* frame;		// frame[N]
+	int frames;			// Frames until the next coarse search.
+
+	// Coefficient tables on the grid.
+	IIR2Coefficients bpf_coef[TONE_TRACKER_MAX_STEPS];
+	int16_t goertzel_coef[TONE_TRACKER_MAX_STEPS];		// Q14
+
+	GoertzelBank<3> fine;
+	GoertzelBank<TONE_TRACKER_COARSE_BINS> coarse;
+	int coarse_index[TONE_TRACKER_COARSE_BINS];			// Grid of the coarse bins.
+	int32_t energy[TONE_TRACKER_COARSE_BINS];			// Smoothed squared magnitude. Q31.
+
+	IIR2DirectFormI* bpf;
+	Goertzel* goertzel;
+	SlidingGoertzel* sliding_goertzel;
+
+	void process(bool mark);
+	void search(void);
+	void estimate(void);
+	void retune(void);
+	void apply(void);
+};
+
+#endif
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,116 @@
+/*==============================================================================
+* @brief	Weighted operation counter (WMOPS) for the Basic Operators.
+*			Compatible with the complexity counting of ITU-T G.191 Software tools STL.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#include "wmops.h"
+
+#ifdef	WMOPS
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+*	Weights of the STL2005 Basic Operators.
+*/
+static const uint8_t weight[NUMOF_WMOPS_OP] = {
+	[WMOPS_add]			= 1,	[WMOPS_sub]			= 1,	[WMOPS_abs_s]		= 1,
+	[WMOPS_shl]			= 1,	[WMOPS_shr]			= 1,	[WMOPS_extract_h]	= 1,
+	[WMOPS_extract_l]	= 1,	[WMOPS_mult]		= 1,	[WMOPS_L_mult]		= 1,
+	[WMOPS_negate]		= 1,	[WMOPS_round_fx]	= 1,	[WMOPS_L_mac]		= 1,
+	[WMOPS_L_msu]		= 1,	[WMOPS_L_macNs]		= 1,	[WMOPS_L_msuNs]		= 1,
+	[WMOPS_L_add]		= 1,	[WMOPS_L_sub]		= 1,	[WMOPS_L_add_c]		= 2,
+	[WMOPS_L_sub_c]		= 2,	[WMOPS_L_negate]	= 1,	[WMOPS_L_shl]		= 1,
+	[WMOPS_L_shr]		= 1,	[WMOPS_mult_r]		= 1,	[WMOPS_shr_r]		= 3,
+	[WMOPS_mac_r]		= 1,	[WMOPS_msu_r]		= 1,	[WMOPS_L_deposit_h]	= 1,
+	[WMOPS_L_deposit_l]	= 1,	[WMOPS_L_shr_r]		= 3,	[WMOPS_L_abs]		= 1,
+	[WMOPS_L_sat]		= 4,	[WMOPS_norm_s]		= 15,	[WMOPS_div_s]		= 18,
+	[WMOPS_norm_l]		= 30,	[WMOPS_i_mult]		= 3,	[WMOPS_L_mls]		= 5,
+	[WMOPS_div_l]		= 32,	[WMOPS_L_mult0]		= 1,	[WMOPS_L_mac0]		= 1,
+	[WMOPS_L_msu0]		= 1,	[WMOPS_s_max]		= 1,	[WMOPS_s_min]		= 1,
+	[WMOPS_L_max]		= 1,	[WMOPS_L_min]		= 1,
+	// math_op: Estimated as the equivalent Basic Operators.
+	[WMOPS_sqrt_l]		= 48,	[WMOPS_log2_l]		= 36,	[WMOPS_atan2_s]		= 52,
+};
+
+static const char* const stage_name[NUMOF_WMOPS_STAGE] = {
+	"Other", "BPF", "AGC", "Goertzel", "Smoother", "Tracker", "Decimator",
+};
+
+uint32_t wmops_counter[NUMOF_WMOPS_STAGE][NUMOF_WMOPS_OP];
+WMOPS_STAGE wmops_stage = WMOPS_STAGE_OTHER;
+
+static uint32_t frames = 0;
+
+
+WMOPS_STAGE wmops_set_stage(WMOPS_STAGE stage)
+{
+	WMOPS_STAGE prev = wmops_stage;
+	wmops_stage = stage;
+	return prev;
+}
+
+void wmops_frame(void)
+{
+	frames++;
+}
+
+void wmops_reset(void)
+{
+	memset(wmops_counter, 0, sizeof(wmops_counter));
+	frames = 0;
+}
+
+void wmops_output(float frame_rate)
+{
+	float total = 0;
+
+	printf("WMOPS: %lu frames, %.1f frames/sec\n", (unsigned long)frames, frame_rate);
+	if(0 == frames) {
+		return;
+	}
+
+	for(int stage = 0; stage < NUMOF_WMOPS_STAGE; stage++) {
+		uint64_t ops = 0;
+		for(int op = 0; op < NUMOF_WMOPS_OP; op++) {
+			ops += (uint64_t)weight[op]*wmops_counter[stage][op];
+		}
+
+		float per_frame = (float)ops/frames;
+		total += per_frame;
+
+		printf("  %-9s %10.1f ops/frame %8.4f WMOPS\n", stage_name[stage], per_frame, per_frame*frame_rate*1e-6f);
+	}
+	printf("  %-9s %10.1f ops/frame %8.4f WMOPS\n", "Total", total, total*frame_rate*1e-6f);
+}
+
+#endif	/* WMOPS */
+/*==============================================================================
+*	End
+*===============================================================================*/
@@ -0,0 +1,142 @@
+/*==============================================================================
+* @brief	Weighted operation counter (WMOPS) for the Basic Operators.
+*			Compatible with the complexity counting of ITU-T G.191 Software tools STL.
+*
+*	@author		Sho Ikeda (JJ1LFO@jarl.com)
+*	@Date		Oct. 16th 2026
+*
+*	@copyright
+*		Copyright (c) 2026 Sho Ikeda.
+*
+*		MIT License
+*
+*		Permission is hereby granted, free of charge, to any person obtaining a copy
+*		of this software and associated documentation files (the "Software"), to deal
+*		in the Software without restriction, including without limitation the rights
+*		to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*		copies of the Software, and to permit persons to whom the Software is
+*		furnished to do so, subject to the following conditions:
+*
+*		The above copyright notice and this permission notice shall be included in all
+*		copies or substantial portions of the Software.
+*
+*		THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*		IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*		FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*		AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*		LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*		OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*		SOFTWARE.
+*
+*===============================================================================*/
+#ifndef _WMOPS_H
+#define _WMOPS_H
+
+#include <stdint.h>
+
+//******** Configurations ********************************************
+//--------	Count the Basic Operators per pipeline stage. -------------
+// #define	WMOPS
+//--------------------------------------------------------------------
+
+/**
+*	Basic Operators to be counted.
+*/
+typedef enum {
+	WMOPS_add = 0,	WMOPS_sub,		WMOPS_abs_s,	WMOPS_shl,		WMOPS_shr,
+	WMOPS_extract_h,WMOPS_extract_l,WMOPS_mult,		WMOPS_L_mult,	WMOPS_negate,
+	WMOPS_round_fx,	WMOPS_L_mac,	WMOPS_L_msu,	WMOPS_L_macNs,	WMOPS_L_msuNs,
+	WMOPS_L_add,	WMOPS_L_sub,	WMOPS_L_add_c,	WMOPS_L_sub_c,	WMOPS_L_negate,
+	WMOPS_L_shl,	WMOPS_L_shr,	WMOPS_mult_r,	WMOPS_shr_r,	WMOPS_mac_r,
+	WMOPS_msu_r,	WMOPS_L_deposit_h,WMOPS_L_deposit_l,WMOPS_L_shr_r,WMOPS_L_abs,
+	WMOPS_L_sat,	WMOPS_norm_s,	WMOPS_div_s,	WMOPS_norm_l,	WMOPS_i_mult,
+	WMOPS_L_mls,	WMOPS_div_l,	WMOPS_L_mult0,	WMOPS_L_mac0,	WMOPS_L_msu0,
+	WMOPS_s_max,	WMOPS_s_min,	WMOPS_L_max,	WMOPS_L_min,
+	WMOPS_sqrt_l,	WMOPS_log2_l,	WMOPS_atan2_s,		// math_op
+	NUMOF_WMOPS_OP
+} WMOPS_OP;
+
+/**
+*	Pipeline stages. Operators are counted to the current stage.
+*/
+typedef enum {
+	WMOPS_STAGE_OTHER = 0,
+	WMOPS_STAGE_BPF,			// IIRFilter2::filter (and other IIR filters)
+	WMOPS_STAGE_AGC,			// Agc::process
+	WMOPS_STAGE_GOERTZEL,		// Goertzel::getMagnitude (or EnvelopeDetector)
+	WMOPS_STAGE_SMOOTHER,		// Smoother::smooth
+	WMOPS_STAGE_TRACKER,		// ToneTracker::push
+	WMOPS_STAGE_DECIMATOR,		// Decimator::decimate
+	NUMOF_WMOPS_STAGE
+} WMOPS_STAGE;
+
+
+#ifdef	WMOPS
+
+#ifdef	__cplusplus
+	extern "C" {
+#endif
+
+extern uint32_t wmops_counter[NUMOF_WMOPS_STAGE][NUMOF_WMOPS_OP];
+extern WMOPS_STAGE wmops_stage;
+
+/**
+* @brief	Select the stage to be counted.
+*
+* @param[in] stage	New stage.
+*
+* @return	Previous stage.
+*/
+WMOPS_STAGE wmops_set_stage(WMOPS_STAGE stage);
+
+/**
+* @brief	Mark the end of a frame.
+*/
+void wmops_frame(void);
+
+/**
+* @brief	Clear all counters and the number of frames.
+*/
+void wmops_reset(void);
+
+/**
+* @brief	Print weighted operations per frame and per second for each stage.
+*
+* @param[in] frame_rate	Frames per second of audio. = sampling_freq/samples_per_frame.
+*/
+void wmops_output(float frame_rate);
+
+#ifdef	__cplusplus
+	}
+#endif
+
+	#define	WMOPS_COUNT(op)		(wmops_counter[wmops_stage][WMOPS_##op]++)
+	#define	WMOPS_UNCOUNT(op)	(wmops_counter[wmops_stage][WMOPS_##op]--)		// Nested operator.
+
+	#ifdef	__cplusplus
+		/**
+		* @brief	Count to the stage while the scope is alive.
+		*/
+		class WmopsStageScope {
+		public:
+			WmopsStageScope(WMOPS_STAGE stage) : prev(wmops_set_stage(stage))	{ }
+			~WmopsStageScope()													{ wmops_set_stage(prev); }
+		private:
+			WMOPS_STAGE prev;
+		};
+
+		#define	WMOPS_STAGE_SCOPE(stage)	WmopsStageScope wmops_stage_scope(stage)
+	#endif
+
+#else
+
+	#define	WMOPS_COUNT(op)				((void)0)
+	#define	WMOPS_UNCOUNT(op)			((void)0)
+	#define	WMOPS_STAGE_SCOPE(stage)	((void)0)
+
+#endif	/* WMOPS */
+
+#endif
+/*==============================================================================
+*	End
+==============================================================================*/